@@ -0,0 +1,484 @@
+// Garry's Mod Offset Scanner - benchmark suite
+//
+// Generates synthetic module images (seeded code-like bytes with planted
+// signatures) and times the scanning paths of GModScanner.cpp on them.
+// Runs headless, no game or process needed.
+//
+// Build:
+//   Linux:   g++ -std=c++17 -O2 -pthread GModBench.cpp -o gmodbench
+//   Windows: cl /std:c++17 /O2 /EHsc GModBench.cpp
+//
+// Usage: gmodbench [--quick] [--seed <n>]
+
+#define GMOD_SCANNER_NO_MAIN
+#include "GModScanner.cpp"
+
+#include <new>
+#include <cstdlib>
+
+// Count heap allocations so every benchmark can report them.
+// GCC flags free() in a replaced operator delete as a mismatch; it is not.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static std::atomic<size_t> g_allocations(0);
+
+void* operator new(size_t size)
+{
+    g_allocations++;
+    if (void* p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+// Module image held in memory; optionally hides View() to force copied reads
+class BufferSource : public MemorySource
+{
+public:
+    std::vector<uint8_t> bytes;
+    uintptr_t base = 0x10000000;
+    bool zeroCopy = true;
+
+    bool Read(uintptr_t address, void* out, size_t size) override
+    {
+        if (address < base || address - base + size > bytes.size())
+            return false;
+        memcpy(out, bytes.data() + (address - base), size);
+        return true;
+    }
+
+    const uint8_t* View(uintptr_t address, size_t size) override
+    {
+        if (!zeroCopy || address < base || address - base + size > bytes.size())
+            return nullptr;
+        return bytes.data() + (address - base);
+    }
+};
+
+// Small, fast, seeded generator
+struct XorShift
+{
+    uint64_t state;
+
+    explicit XorShift(uint64_t seed) : state(seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+    uint64_t Next()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+// Synthetic module: code-like filler with signatures planted at known offsets
+struct SyntheticModule
+{
+    std::vector<uint8_t> bytes;
+    std::vector<size_t> planted;
+};
+
+// Byte table weighted like x86 code so anchor selection sees realistic frequencies
+static std::vector<uint8_t> CodeByteTable()
+{
+    std::vector<uint8_t> table;
+    for (int b = 0; b < 256; b++)
+    {
+        int weight = ByteCommonness(static_cast<uint8_t>(b)) * 2;
+        for (int i = 0; i < weight; i++)
+            table.push_back(static_cast<uint8_t>(b));
+    }
+    return table;
+}
+
+// Write one copy of a signature at `at`, wildcards filled with random bytes
+static void Plant(SyntheticModule& module, const std::vector<int>& signature, size_t at, XorShift& rng)
+{
+    for (size_t j = 0; j < signature.size(); j++)
+        module.bytes[at + j] = signature[j] == -1 ? static_cast<uint8_t>(rng.Next()) : static_cast<uint8_t>(signature[j]);
+    module.planted.push_back(at);
+}
+
+// `density` is planted copies per MB of each signature
+static SyntheticModule GenerateModule(size_t size, uint64_t seed, const std::vector<std::vector<int>>& signatures, double density)
+{
+    static const std::vector<uint8_t> table = CodeByteTable();
+
+    SyntheticModule module;
+    module.bytes.resize(size);
+    XorShift rng(seed);
+    for (size_t i = 0; i < size; i += 8)
+    {
+        uint64_t r = rng.Next();
+        for (size_t k = 0; k < 8 && i + k < size; k++)
+            module.bytes[i + k] = table[((r >> (k * 8)) & 0xFF) * table.size() / 256];
+    }
+
+    size_t copies = static_cast<size_t>(density * size / (1024.0 * 1024.0));
+    for (const auto& signature : signatures)
+    {
+        for (size_t c = 0; c < copies && size > signature.size(); c++)
+            Plant(module, signature, rng.Next() % (size - signature.size()), rng);
+    }
+    std::sort(module.planted.begin(), module.planted.end());
+    return module;
+}
+
+// Random signature with the given length and share of wildcard bytes
+static std::string RandomPattern(size_t length, double wildcardRatio, XorShift& rng)
+{
+    static const std::vector<uint8_t> table = CodeByteTable();
+
+    std::ostringstream out;
+    out << std::hex << std::uppercase << std::setfill('0');
+    for (size_t j = 0; j < length; j++)
+    {
+        if (j)
+            out << ' ';
+
+        // Keep the first byte fixed so every pattern has an anchor
+        if (j && (rng.Next() % 1000) < wildcardRatio * 1000)
+            out << '?';
+        else
+            out << std::setw(2) << static_cast<int>(table[rng.Next() % table.size()]);
+    }
+    return out.str();
+}
+
+struct Measurement
+{
+    double seconds;
+    size_t bytes;
+    size_t matches;
+    size_t allocations;
+};
+
+// Run fn until at least 0.2s have passed (min 3 runs), report the best run
+template<typename Fn>
+static Measurement Measure(size_t bytesPerRun, Fn&& fn)
+{
+    Measurement best = { 1e30, bytesPerRun, 0, 0 };
+    auto total = std::chrono::steady_clock::now();
+    for (int run = 0; run < 3 || std::chrono::steady_clock::now() - total < std::chrono::milliseconds(200); run++)
+    {
+        size_t allocations = g_allocations;
+        auto start = std::chrono::steady_clock::now();
+        size_t matches = fn();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (seconds < best.seconds)
+            best = { seconds, bytesPerRun, matches, g_allocations - allocations };
+    }
+    return best;
+}
+
+static void Print(const std::string& name, const std::string& params, const Measurement& m)
+{
+    std::cout << std::left << std::setw(26) << name << std::setw(34) << params << std::right << std::fixed
+              << std::setprecision(2) << std::setw(9) << (m.bytes ? m.bytes / m.seconds / 1e9 : 0.0) << " GB/s"
+              << std::setprecision(0) << std::setw(14) << m.matches / m.seconds << " match/s"
+              << std::setw(10) << m.allocations << " allocs" << std::setprecision(3) << std::setw(11)
+              << m.seconds * 1000.0 << " ms\n" << std::defaultfloat;
+}
+
+// Scanner over a synthetic module with console output silenced
+static std::unique_ptr<GModOffsetScanner> MakeScanner(std::shared_ptr<BufferSource> source, size_t threads)
+{
+    auto scanner = std::make_unique<GModOffsetScanner>();
+    scanner->memory = source;
+    scanner->SetThreadCount(threads);
+
+    std::streambuf* old = std::cout.rdbuf(nullptr);
+    scanner->SetModule("synthetic.dll", source->base, source->bytes.size());
+    std::cout.rdbuf(old);
+    return scanner;
+}
+
+// Find every match with repeated first-match calls
+static size_t CountAll(FindFirstFn fn, const uint8_t* data, size_t size, const SignatureView& pattern)
+{
+    size_t count = 0;
+    for (size_t pos = 0; pos < size;)
+    {
+        size_t hit = fn(data + pos, size - pos, pattern);
+        if (hit == kNoMatch)
+            break;
+        count++;
+        pos += hit + 1;
+    }
+    return count;
+}
+
+int main(int argc, char* argv[])
+{
+    bool quick = false;
+    uint64_t seed = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--quick")
+            quick = true;
+        else if (arg == "--seed" && i + 1 < argc)
+            seed = strtoull(argv[++i], nullptr, 10);
+        else
+        {
+            std::cout << "Usage: " << argv[0] << " [--quick] [--seed <n>]\n";
+            return 1;
+        }
+    }
+
+    const char* simdName = "";
+    SelectFindFirst(&simdName);
+    const size_t hwThreads = std::max<unsigned>(std::thread::hardware_concurrency(), 1u);
+    const size_t defaultSize = quick ? 8 << 20 : 32 << 20;
+
+    std::cout << "GModScanner benchmark (seed " << seed << ", " << simdName << ", " << hwThreads << " hardware threads)\n\n";
+
+    GModOffsetScanner parser;
+    XorShift rng(seed);
+
+    // PatternToBytes vs compile-time signatures
+    {
+        std::cout << "[Pattern parsing]\n";
+        const std::string pattern = "48 8B 0D ? ? ? ? 48 85 C9 74 ? 48 8B 01";
+        const size_t iterations = 100000;
+
+        Print("PatternToBytes", "15 bytes x100000", Measure(0, [&]
+        {
+            size_t total = 0;
+            for (size_t i = 0; i < iterations; i++)
+                total += parser.PatternToBytes(pattern).size();
+            return total ? 0 : 1;
+        }));
+        Print("GMOD_SIG view", "15 bytes x100000", Measure(0, [&]
+        {
+            size_t total = 0;
+            for (size_t i = 0; i < iterations; i++)
+                total += GMOD_SIG("48 8B 0D ? ? ? ? 48 85 C9 74 ? 48 8B 01").length;
+            return total ? 0 : 1;
+        }));
+        std::cout << "\n";
+    }
+
+    // First-match routines, swept over pattern length and wildcard ratio
+    {
+        std::cout << "[FindFirst kernels, find-all over " << (defaultSize >> 20) << " MB]\n";
+        std::vector<std::pair<const char*, FindFirstFn>> kernels = { { "scalar", FindFirstScalar } };
+#ifdef GMOD_HAVE_SIMD
+        kernels.push_back({ "SSE2", FindFirstSSE2 });
+        if (CpuHasAVX2())
+            kernels.push_back({ "AVX2", FindFirstAVX2 });
+#endif
+
+        for (size_t length : { 8, 16, 32 })
+        {
+            for (double wildcards : { 0.0, 0.25, 0.5 })
+            {
+                std::string text = RandomPattern(length, wildcards, rng);
+                auto bytes = parser.PatternToBytes(text);
+                RuntimeSignature signature(text, bytes);
+                SignatureView view = signature.View();
+                SyntheticModule module = GenerateModule(defaultSize, seed + length, { bytes }, 4.0);
+
+                std::ostringstream params;
+                params << "len " << length << ", " << static_cast<int>(wildcards * 100) << "% wildcards";
+                for (const auto& kernel : kernels)
+                {
+                    Print(std::string("FindFirst ") + kernel.first, params.str(), Measure(module.bytes.size(), [&]
+                    {
+                        return CountAll(kernel.second, module.bytes.data(), module.bytes.size(), view);
+                    }));
+                }
+            }
+        }
+        std::cout << "\n";
+    }
+
+    // Approximate matcher against the exact kernel on the same module
+    {
+        std::cout << "[Approximate matching over " << (defaultSize >> 20) << " MB]\n";
+        const std::string text = "48 8B 0D ? ? ? ? 48 85 C9 74 ? 48 8B 01";
+        auto bytes = parser.PatternToBytes(text);
+        RuntimeSignature signature(text, bytes);
+        SignatureView view = signature.View();
+        SyntheticModule module = GenerateModule(defaultSize, seed + 7, { bytes }, 4.0);
+
+        Print("FindFirst exact", "len 15", Measure(module.bytes.size(), [&]
+        {
+            return CountAll(SelectFindFirst(), module.bytes.data(), module.bytes.size(), view);
+        }));
+        for (size_t mismatches : { 1, 2, 3 })
+        {
+            ApproximateMatcher matcher;
+            matcher.Compile(view, mismatches);
+            std::ostringstream params;
+            params << "len 15, k = " << mismatches << (matcher.Filtered() ? ", pigeonhole" : ", Shift-Or");
+            Print("Approximate", params.str(), Measure(module.bytes.size(), [&]
+            {
+                size_t hits = 0;
+                matcher.Scan(module.bytes.data(), module.bytes.size(), [&](size_t, size_t) { hits++; });
+                return hits;
+            }));
+        }
+        std::cout << "\n";
+    }
+
+    // String extraction over .rdata-like data and the xref sweep over code
+    {
+        std::cout << "[Strings and cross-references over " << (defaultSize >> 20) << " MB]\n";
+        std::vector<uint8_t> rdata(defaultSize);
+        XorShift rng(seed + 11);
+        for (size_t i = 0; i < rdata.size();)
+        {
+            // Binary runs with ASCII strings and some UTF-16 ones in between
+            uint64_t r = rng.Next();
+            size_t length = 4 + r % 40;
+            bool wide = (r >> 8) % 8 == 0, text = (r >> 16) % 2 == 0;
+            for (size_t k = 0; k < length && i < rdata.size(); k++)
+            {
+                uint8_t c = text ? static_cast<uint8_t>(0x20 + rng.Next() % 0x5F) : static_cast<uint8_t>(rng.Next());
+                rdata[i++] = c;
+                if (wide && text && i < rdata.size())
+                    rdata[i++] = 0;
+            }
+            if (i < rdata.size())
+                rdata[i++] = 0;
+        }
+
+        Print("Scalar strings", "ASCII only", Measure(rdata.size(), [&]
+        {
+            size_t count = 0, run = 0;
+            for (uint8_t b : rdata)
+            {
+                if ((b >= 0x20 && b < 0x7F) || b == '\t' || b == '\n' || b == '\r')
+                    run++;
+                else
+                {
+                    count += !b && run >= StringTable::kMinLength;
+                    run = 0;
+                }
+            }
+            return count;
+        }));
+        Print("StringTable::Add", "ASCII + UTF-16", Measure(rdata.size(), [&]
+        {
+            StringTable table;
+            table.Add(rdata.data(), rdata.size(), 0);
+            return table.Size();
+        }));
+        Print("StringTable", "ASCII + UTF-16, sorted", Measure(rdata.size(), [&]
+        {
+            StringTable table;
+            table.Add(rdata.data(), rdata.size(), 0);
+            table.Finish();
+            return table.Size();
+        }));
+
+        SyntheticModule module = GenerateModule(defaultSize, seed + 13, {}, 0.0);
+        Print("XrefIndex", "x64, one decoding pass", Measure(module.bytes.size(), [&]
+        {
+            XrefIndex index;
+            index.Add(module.bytes.data(), module.bytes.size(), 0, true, 0, module.bytes.size(), [](uint32_t) { return false; });
+            index.Finish();
+            return index.Size();
+        }));
+        std::cout << "\n";
+    }
+
+    // Built-in signature set: FindPattern per pattern vs one multi-pattern pass
+    std::vector<std::vector<int>> builtin;
+    for (const auto* list : { &GModOffsetScanner::entityListPatterns, &GModOffsetScanner::localPlayerPatterns,
+                              &GModOffsetScanner::viewMatrixPatterns })
+    {
+        for (const auto& pattern : *list)
+            builtin.push_back(parser.PatternToBytes(pattern.view.text));
+    }
+
+    for (size_t size : { size_t(4) << 20, defaultSize, size_t(quick ? 16 : 64) << 20 })
+    {
+        std::cout << "[Built-in signatures, " << (size >> 20) << " MB module]\n";
+        // Plant each signature once near the end so first-match scans read the whole module
+        SyntheticModule module = GenerateModule(size, seed + size, {}, 0.0);
+        XorShift plantRng(seed);
+        for (size_t i = 0; i < builtin.size(); i++)
+            Plant(module, builtin[i], size - 0x10000 + i * 0x1000, plantRng);
+
+        auto source = std::make_shared<BufferSource>();
+        source->bytes = std::move(module.bytes);
+
+        for (bool zeroCopy : { true, false })
+        {
+            source->zeroCopy = zeroCopy;
+            const char* mode = zeroCopy ? "mapped" : "copied reads";
+
+            auto scanner = MakeScanner(source, 1);
+            Print("FindPattern x16", mode, Measure(size * builtin.size(), [&]
+            {
+                size_t found = 0;
+                for (const auto* list : { &GModOffsetScanner::entityListPatterns, &GModOffsetScanner::localPlayerPatterns,
+                                          &GModOffsetScanner::viewMatrixPatterns })
+                {
+                    for (const auto& pattern : *list)
+                        found += scanner->FindPattern(pattern.view.text) != 0;
+                }
+                return found;
+            }));
+
+            Print("FindAllPattern x16", mode, Measure(size * builtin.size(), [&]
+            {
+                size_t found = 0;
+                for (const auto* list : { &GModOffsetScanner::entityListPatterns, &GModOffsetScanner::localPlayerPatterns,
+                                          &GModOffsetScanner::viewMatrixPatterns })
+                {
+                    for (const auto& pattern : *list)
+                        found += scanner->FindAllPattern(pattern.view, scanner->codeRanges).size();
+                }
+                return found;
+            }));
+
+            // Thread sweep over the single-pass engine
+            std::vector<size_t> counts;
+            for (size_t n = 1; n < hwThreads; n *= 2)
+                counts.push_back(n);
+            counts.push_back(hwThreads);
+
+            for (size_t threads : counts)
+            {
+                auto passScanner = MakeScanner(source, threads);
+                passScanner->GetPool();
+                std::ostringstream params;
+                params << mode << ", " << threads << " thread(s)";
+                Print("Signature pass", params.str(), Measure(size, [&]
+                {
+                    passScanner->RunSignaturePass();
+                    size_t found = 0;
+                    for (const auto& hit : passScanner->signatureHits)
+                        found += hit.second != 0;
+                    return found;
+                }));
+            }
+        }
+
+        // Every hit the multi-pattern engine reports, not just the first
+        MultiPatternScanner matcher;
+        for (const auto* list : { &GModOffsetScanner::entityListPatterns, &GModOffsetScanner::localPlayerPatterns,
+                                  &GModOffsetScanner::viewMatrixPatterns })
+        {
+            for (const auto& pattern : *list)
+                matcher.AddPattern(pattern.view);
+        }
+        matcher.Compile();
+        Print("MultiPattern all hits", "16 signatures", Measure(size, [&]
+        {
+            size_t hits = 0;
+            matcher.Scan(source->bytes.data(), source->bytes.size(), [&](size_t, size_t) { hits++; });
+            return hits;
+        }));
+        std::cout << "\n";
+    }
+
+    return 0;
+}
@@ -1,619 +1,7222 @@
-#include <Windows.h>
-#include <TlHelp32.h>
-#include <Psapi.h>
-#include <iostream>
-#include <vector>
-#include <string>
-#include <fstream>
-#include <iomanip>
-#include <map>
-#include <algorithm>
-
-class GModOffsetScanner
-{
-public:
-    HANDLE hProcess;
-    DWORD processId;
-    std::string processName;
-    uintptr_t moduleBase;
-    size_t moduleSize;
-
-    GModOffsetScanner() : hProcess(nullptr), processId(0), moduleBase(0), moduleSize(0) {}
-
-    ~GModOffsetScanner()
-    {
-        if (hProcess)
-            CloseHandle(hProcess);
-    }
-
-    // List all running processes
-    std::vector<std::pair<std::string, DWORD>> ListProcesses()
-    {
-        std::vector<std::pair<std::string, DWORD>> processes;
-        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-        if (snapshot == INVALID_HANDLE_VALUE)
-            return processes;
-
-        PROCESSENTRY32 entry;
-        entry.dwSize = sizeof(PROCESSENTRY32);
-
-        if (Process32First(snapshot, &entry))
-        {
-            do
-            {
-                processes.push_back({ entry.szExeFile, entry.th32ProcessID });
-            } while (Process32Next(snapshot, &entry));
-        }
-
-        CloseHandle(snapshot);
-        return processes;
-    }
-
-    // List modules for a process
-    std::vector<std::string> ListModules(DWORD pid)
-    {
-        std::vector<std::string> modules;
-        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, pid);
-        if (snapshot == INVALID_HANDLE_VALUE)
-            return modules;
-
-        MODULEENTRY32 entry;
-        entry.dwSize = sizeof(MODULEENTRY32);
-
-        if (Module32First(snapshot, &entry))
-        {
-            do
-            {
-                modules.push_back(entry.szModule);
-            } while (Module32Next(snapshot, &entry));
-        }
-
-        CloseHandle(snapshot);
-        return modules;
-    }
-
-    // Attach to process by PID
-    bool AttachToProcess(DWORD pid)
-    {
-        processId = pid;
-        hProcess = OpenProcess(PROCESS_ALL_ACCESS, FALSE, processId);
-        if (!hProcess)
-        {
-            std::cout << "[-] Failed to open process. Run as administrator.\n";
-            return false;
-        }
-
-        // Get process name
-        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-        PROCESSENTRY32 entry;
-        entry.dwSize = sizeof(PROCESSENTRY32);
-        
-        if (Process32First(snapshot, &entry))
-        {
-            do
-            {
-                if (entry.th32ProcessID == pid)
-                {
-                    processName = entry.szExeFile;
-                    break;
-                }
-            } while (Process32Next(snapshot, &entry));
-        }
-        CloseHandle(snapshot);
-
-        std::cout << "[+] Attached to process: " << processName << " (PID: " << processId << ")\n";
-        return true;
-    }
-
-    // Get module info
-    bool GetModuleInfo(const std::string& moduleName)
-    {
-        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, processId);
-        if (snapshot == INVALID_HANDLE_VALUE)
-            return false;
-
-        MODULEENTRY32 entry;
-        entry.dwSize = sizeof(MODULEENTRY32);
-
-        if (Module32First(snapshot, &entry))
-        {
-            do
-            {
-                if (_stricmp(entry.szModule, moduleName.c_str()) == 0)
-                {
-                    moduleBase = reinterpret_cast<uintptr_t>(entry.modBaseAddr);
-                    moduleSize = entry.modBaseSize;
-                    CloseHandle(snapshot);
-
-                    std::cout << "[+] Module: " << moduleName << "\n";
-                    std::cout << "    Base: 0x" << std::hex << moduleBase << "\n";
-                    std::cout << "    Size: 0x" << moduleSize << std::dec << "\n";
-                    return true;
-                }
-            } while (Module32Next(snapshot, &entry));
-        }
-
-        CloseHandle(snapshot);
-        return false;
-    }
-
-    // Read memory
-    template<typename T>
-    T Read(uintptr_t address)
-    {
-        T value{};
-        SIZE_T bytesRead;
-        ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(address), &value, sizeof(T), &bytesRead);
-        return value;
-    }
-
-    // Read bytes
-    std::vector<uint8_t> ReadBytes(uintptr_t address, size_t size)
-    {
-        std::vector<uint8_t> buffer(size);
-        SIZE_T bytesRead;
-        ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(address), buffer.data(), size, &bytesRead);
-        return buffer;
-    }
-
-    // Pattern to bytes
-    std::vector<int> PatternToBytes(const std::string& pattern)
-    {
-        std::vector<int> bytes;
-        char* start = const_cast<char*>(pattern.c_str());
-        char* end = start + pattern.length();
-
-        for (char* current = start; current < end; ++current)
-        {
-            if (*current == '?')
-            {
-                ++current;
-                if (current < end && *current == '?')
-                    ++current;
-                bytes.push_back(-1);
-            }
-            else
-            {
-                bytes.push_back(strtoul(current, &current, 16));
-            }
-        }
-
-        return bytes;
-    }
-
-    // Find pattern
-    uintptr_t FindPattern(const std::string& pattern)
-    {
-        auto patternBytes = PatternToBytes(pattern);
-        
-        // Read module in chunks to avoid memory issues
-        const size_t chunkSize = 0x100000; // 1MB chunks
-        
-        for (size_t offset = 0; offset < moduleSize; offset += chunkSize)
-        {
-            size_t readSize = min(chunkSize, moduleSize - offset);
-            std::vector<uint8_t> chunk = ReadBytes(moduleBase + offset, readSize);
-
-            for (size_t i = 0; i < chunk.size() - patternBytes.size(); i++)
-            {
-                bool found = true;
-                for (size_t j = 0; j < patternBytes.size(); j++)
-                {
-                    if (patternBytes[j] != -1 && chunk[i + j] != patternBytes[j])
-                    {
-                        found = false;
-                        break;
-                    }
-                }
-
-                if (found)
-                    return moduleBase + offset + i;
-            }
-        }
-
-        return 0;
-    }
-
-    // Garry's Mod specific patterns (Source Engine)
-    uintptr_t ScanGModEntityList()
-    {
-        std::cout << "\n[*] Scanning for Garry's Mod EntityList...\n";
-
-        // Source Engine entity list patterns
-        std::vector<std::string> patterns = {
-            // Common Source Engine patterns
-            "8B 0D ? ? ? ? 8B 01 FF 50 ? 85 C0",           // mov ecx,[addr]; mov eax,[ecx]
-            "A1 ? ? ? ? 8B 14 B8 85 D2",                   // mov eax,[addr]; mov edx,[eax+edi*4]
-            "8B 15 ? ? ? ? 33 C9 83 FA FF",                // mov edx,[addr]
-            "8B 0D ? ? ? ? 8B 14 81",                      // mov ecx,[addr]; mov edx,[ecx+eax*4]
-            // x64 patterns
-            "48 8B 0D ? ? ? ? 48 85 C9 74 ? 48 8B 01",    // mov rcx,[addr]
-            "4C 8B 05 ? ? ? ? 4D 85 C0",                   // mov r8,[addr]
-        };
-
-        for (const auto& pattern : patterns)
-        {
-            std::cout << "    Trying pattern: " << pattern.substr(0, 20) << "...\n";
-            uintptr_t result = FindPattern(pattern);
-            if (result)
-            {
-                // Check if x86 or x64
-                bool is64bit = (pattern.find("48") == 0 || pattern.find("4C") == 0);
-                
-                if (is64bit)
-                {
-                    int32_t offset = Read<int32_t>(result + 3);
-                    uintptr_t address = result + 7 + offset;
-                    std::cout << "    [x64] Found at: 0x" << std::hex << result << "\n";
-                    std::cout << "    Resolved: 0x" << address << std::dec << "\n";
-                    return address;
-                }
-                else
-                {
-                    uintptr_t address = Read<uintptr_t>(result + 2);
-                    std::cout << "    [x86] Found at: 0x" << std::hex << result << "\n";
-                    std::cout << "    Resolved: 0x" << address << std::dec << "\n";
-                    return address;
-                }
-            }
-        }
-
-        std::cout << "    [-] Not found\n";
-        return 0;
-    }
-
-    // Scan for local player
-    uintptr_t ScanGModLocalPlayer()
-    {
-        std::cout << "\n[*] Scanning for Garry's Mod LocalPlayer...\n";
-
-        std::vector<std::string> patterns = {
-            // Source Engine local player patterns
-            "8B 0D ? ? ? ? 83 F9 FF 74 ? 8B 01",          // mov ecx,[addr]
-            "A1 ? ? ? ? 83 F8 FF 74 ? 8B 08",             // mov eax,[addr]
-            "8B 15 ? ? ? ? 85 D2 74 ? 8B 02",             // mov edx,[addr]
-            // x64 patterns
-            "48 8B 0D ? ? ? ? 48 85 C9 74 ? E8",          // mov rcx,[addr]
-            "48 8B 05 ? ? ? ? 48 85 C0 74 ? 48 8B 08",    // mov rax,[addr]
-        };
-
-        for (const auto& pattern : patterns)
-        {
-            std::cout << "    Trying pattern: " << pattern.substr(0, 20) << "...\n";
-            uintptr_t result = FindPattern(pattern);
-            if (result)
-            {
-                bool is64bit = (pattern.find("48") == 0);
-                
-                if (is64bit)
-                {
-                    int32_t offset = Read<int32_t>(result + 3);
-                    uintptr_t address = result + 7 + offset;
-                    std::cout << "    [x64] Found at: 0x" << std::hex << result << "\n";
-                    std::cout << "    Resolved: 0x" << address << std::dec << "\n";
-                    return address;
-                }
-                else
-                {
-                    uintptr_t address = Read<uintptr_t>(result + 2);
-                    std::cout << "    [x86] Found at: 0x" << std::hex << result << "\n";
-                    std::cout << "    Resolved: 0x" << address << std::dec << "\n";
-                    return address;
-                }
-            }
-        }
-
-        std::cout << "    [-] Not found\n";
-        return 0;
-    }
-
-    // Scan for view matrix
-    uintptr_t ScanGModViewMatrix()
-    {
-        std::cout << "\n[*] Scanning for Garry's Mod ViewMatrix...\n";
-
-        std::vector<std::string> patterns = {
-            // Source Engine view matrix patterns
-            "F3 0F 10 05 ? ? ? ? F3 0F 11 45",            // movss xmm0,[addr]
-            "0F 10 05 ? ? ? ? 0F 11 45",                  // movups xmm0,[addr]
-            "F3 0F 10 0D ? ? ? ? F3 0F 59 0D",            // movss xmm1,[addr]
-            // x64 patterns
-            "0F 10 05 ? ? ? ? 8D 85 ? ? ? ? B9",         // movups xmm0,[addr]
-            "F3 0F 10 05 ? ? ? ? F3 0F 11 85",           // movss xmm0,[addr]
-        };
-
-        for (const auto& pattern : patterns)
-        {
-            std::cout << "    Trying pattern: " << pattern.substr(0, 20) << "...\n";
-            uintptr_t result = FindPattern(pattern);
-            if (result)
-            {
-                int32_t offset = Read<int32_t>(result + 4);
-                uintptr_t address = result + 8 + offset;
-                std::cout << "    Found at: 0x" << std::hex << result << "\n";
-                std::cout << "    Resolved: 0x" << address << std::dec << "\n";
-                return address;
-            }
-        }
-
-        std::cout << "    [-] Not found\n";
-        return 0;
-    }
-
-    // Save results
-    void SaveResults(const std::string& filename, uintptr_t entityList, uintptr_t localPlayer, uintptr_t viewMatrix)
-    {
-        std::ofstream file(filename);
-        if (!file.is_open())
-            return;
-
-        file << "// Garry's Mod Offsets\n";
-        file << "// Process: " << processName << "\n";
-        file << "// Generated: " << __DATE__ << " " << __TIME__ << "\n\n";
-
-        file << "[Offsets]\n";
-        file << "EntityList=0x" << std::hex << entityList << "\n";
-        file << "LocalPlayer=0x" << localPlayer << "\n";
-        file << "ViewMatrix=0x" << viewMatrix << "\n";
-
-        file << "\n[Module]\n";
-        file << "Base=0x" << moduleBase << "\n";
-        file << "Size=0x" << moduleSize << "\n";
-
-        file << "\n[Entity] ; Source Engine typical offsets\n";
-        file << "Health=0x100\n";
-        file << "Team=0x104\n";
-        file << "Position=0x138\n";
-        file << "Dormant=0xED\n";
-        file << "BoneMatrix=0x26A8\n";
-
-        file.close();
-        std::cout << "\n[+] Results saved to: " << filename << "\n";
-    }
-
-    // Generate header
-    void GenerateHeader(const std::string& filename, uintptr_t entityList, uintptr_t localPlayer, uintptr_t viewMatrix)
-    {
-        std::ofstream file(filename);
-        if (!file.is_open())
-            return;
-
-        file << "// Garry's Mod Auto-Generated Offsets\n";
-        file << "// Process: " << processName << "\n\n";
-
-        file << "#pragma once\n\n";
-        file << "namespace GModOffsets\n{\n";
-        file << "    // Global offsets\n";
-        file << "    constexpr uintptr_t EntityList = 0x" << std::hex << entityList << ";\n";
-        file << "    constexpr uintptr_t LocalPlayer = 0x" << localPlayer << ";\n";
-        file << "    constexpr uintptr_t ViewMatrix = 0x" << viewMatrix << ";\n\n";
-
-        file << "    // Source Engine entity offsets (typical values)\n";
-        file << "    namespace Entity\n";
-        file << "    {\n";
-        file << "        constexpr uintptr_t Health = 0x100;\n";
-        file << "        constexpr uintptr_t Team = 0x104;\n";
-        file << "        constexpr uintptr_t Position = 0x138;\n";
-        file << "        constexpr uintptr_t Dormant = 0xED;\n";
-        file << "        constexpr uintptr_t BoneMatrix = 0x26A8;\n";
-        file << "    }\n";
-        file << "}\n";
-
-        file.close();
-        std::cout << "[+] Header generated: " << filename << "\n";
-    }
-};
-
-// Interactive menu
-void ShowMenu()
-{
-    std::cout << "\n========================================\n";
-    std::cout << "  Garry's Mod Offset Scanner\n";
-    std::cout << "  Educational purposes only!\n";
-    std::cout << "========================================\n\n";
-}
-
-int main()
-{
-    ShowMenu();
-
-    GModOffsetScanner scanner;
-
-    // List all processes
-    std::cout << "[*] Scanning for running processes...\n\n";
-    auto processes = scanner.ListProcesses();
-
-    // Filter for likely game processes
-    std::vector<std::pair<std::string, DWORD>> gameProcesses;
-    for (const auto& proc : processes)
-    {
-        std::string name = proc.first;
-        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-        
-        // Look for game-related processes
-        if (name.find("gmod") != std::string::npos ||
-            name.find("hl2") != std::string::npos ||
-            name.find("garrysmod") != std::string::npos ||
-            name.find("srcds") != std::string::npos)
-        {
-            gameProcesses.push_back(proc);
-        }
-    }
-
-    // Show found game processes
-    if (gameProcesses.empty())
-    {
-        std::cout << "[-] No Garry's Mod processes found!\n";
-        std::cout << "\nShowing all processes instead:\n\n";
-        
-        // Show all processes
-        for (size_t i = 0; i < processes.size() && i < 50; i++)
-        {
-            std::cout << "[" << (i + 1) << "] " << processes[i].first 
-                      << " (PID: " << processes[i].second << ")\n";
-        }
-        
-        std::cout << "\nEnter process number (1-" << min(processes.size(), (size_t)50) << "): ";
-        int choice;
-        std::cin >> choice;
-        
-        if (choice < 1 || choice > min(processes.size(), (size_t)50))
-        {
-            std::cout << "[-] Invalid choice!\n";
-            std::cout << "\nPress Enter to exit...";
-            std::cin.ignore();
-            std::cin.get();
-            return 1;
-        }
-        
-        DWORD selectedPid = processes[choice - 1].second;
-        std::string selectedName = processes[choice - 1].first;
-        
-        std::cout << "\n[+] Selected: " << selectedName << " (PID: " << selectedPid << ")\n";
-        
-        if (!scanner.AttachToProcess(selectedPid))
-        {
-            std::cout << "\nPress Enter to exit...";
-            std::cin.ignore();
-            std::cin.get();
-            return 1;
-        }
-    }
-    else
-    {
-        std::cout << "[+] Found Garry's Mod processes:\n\n";
-        for (size_t i = 0; i < gameProcesses.size(); i++)
-        {
-            std::cout << "[" << (i + 1) << "] " << gameProcesses[i].first 
-                      << " (PID: " << gameProcesses[i].second << ")\n";
-        }
-        
-        std::cout << "\nSelect process (1-" << gameProcesses.size() << "): ";
-        int choice;
-        std::cin >> choice;
-        
-        if (choice < 1 || choice > gameProcesses.size())
-        {
-            std::cout << "[-] Invalid choice!\n";
-            std::cout << "\nPress Enter to exit...";
-            std::cin.ignore();
-            std::cin.get();
-            return 1;
-        }
-        
-        DWORD selectedPid = gameProcesses[choice - 1].second;
-        
-        if (!scanner.AttachToProcess(selectedPid))
-        {
-            std::cout << "\nPress Enter to exit...";
-            std::cin.ignore();
-            std::cin.get();
-            return 1;
-        }
-    }
-
-    // List modules
-    std::cout << "\n[*] Scanning for modules...\n\n";
-    auto modules = scanner.ListModules(scanner.processId);
-    
-    if (modules.empty())
-    {
-        std::cout << "[-] No modules found!\n";
-        std::cout << "\nPress Enter to exit...";
-        std::cin.ignore();
-        std::cin.get();
-        return 1;
-    }
-
-    // Filter for likely game modules
-    std::vector<std::string> gameModules;
-    for (const auto& mod : modules)
-    {
-        std::string name = mod;
-        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
-        
-        if (name.find("client") != std::string::npos ||
-            name.find("engine") != std::string::npos ||
-            name.find("server") != std::string::npos ||
-            name.find(".exe") != std::string::npos)
-        {
-            gameModules.push_back(mod);
-        }
-    }
-
-    if (gameModules.empty())
-        gameModules = modules;
-
-    std::cout << "[+] Found modules:\n\n";
-    for (size_t i = 0; i < gameModules.size() && i < 20; i++)
-    {
-        std::cout << "[" << (i + 1) << "] " << gameModules[i] << "\n";
-    }
-    
-    std::cout << "\nSelect module (1-" << min(gameModules.size(), (size_t)20) << ") [default: 1]: ";
-    std::string input;
-    std::cin.ignore();
-    std::getline(std::cin, input);
-    
-    int moduleChoice = 1;
-    if (!input.empty())
-    {
-        try {
-            moduleChoice = std::stoi(input);
-        } catch (...) {
-            moduleChoice = 1;
-        }
-    }
-    
-    if (moduleChoice < 1 || moduleChoice > min(gameModules.size(), (size_t)20))
-        moduleChoice = 1;
-    
-    std::string selectedModule = gameModules[moduleChoice - 1];
-    
-    if (!scanner.GetModuleInfo(selectedModule))
-    {
-        std::cout << "[-] Failed to get module info!\n";
-        std::cout << "\nPress Enter to exit...";
-        std::cin.get();
-        return 1;
-    }
-
-    // Scan for offsets
-    std::cout << "\n[*] Starting Garry's Mod offset scan...\n";
-    std::cout << "    This may take a few minutes...\n";
-
-    uintptr_t entityList = scanner.ScanGModEntityList();
-    uintptr_t localPlayer = scanner.ScanGModLocalPlayer();
-    uintptr_t viewMatrix = scanner.ScanGModViewMatrix();
-
-    // Display results
-    std::cout << "\n========================================\n";
-    std::cout << "  Scan Results\n";
-    std::cout << "========================================\n";
-    std::cout << "EntityList:  " << (entityList ? "FOUND" : "NOT FOUND") << "\n";
-    std::cout << "LocalPlayer: " << (localPlayer ? "FOUND" : "NOT FOUND") << "\n";
-    std::cout << "ViewMatrix:  " << (viewMatrix ? "FOUND" : "NOT FOUND") << "\n";
-
-    if (entityList || localPlayer || viewMatrix)
-    {
-        scanner.SaveResults("gmod_offsets.ini", entityList, localPlayer, viewMatrix);
-        scanner.GenerateHeader("GModOffsets.h", entityList, localPlayer, viewMatrix);
-
-        std::cout << "\n[*] Next steps:\n";
-        std::cout << "    1. Copy gmod_offsets.ini to your DLL directory\n";
-        std::cout << "    2. Update Memory/Offsets.h with found values\n";
-        std::cout << "    3. Build and inject your DLL\n";
-        std::cout << "    4. Test ESP in Garry's Mod\n";
-    }
-    else
-    {
-        std::cout << "\n[-] No offsets found. Try:\n";
-        std::cout << "    1. Make sure Garry's Mod is running and in-game\n";
-        std::cout << "    2. Try different module (client.dll or engine.dll)\n";
-        std::cout << "    3. Use Cheat Engine for manual scanning\n";
-    }
-
-    std::cout << "\nPress Enter to exit...";
-    std::cin.get();
-    return 0;
-}
+#ifdef _WIN32
+#define NOMINMAX
+#include <Windows.h>
+#include <TlHelp32.h>
+#include <Psapi.h>
+#else
+#include <cstdint>
+#include <dirent.h>
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+typedef uint32_t DWORD;
+#define _stricmp strcasecmp
+#endif
+#include <iostream>
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <filesystem>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// Relative frequency of a byte in x86/x64 code; lower means rarer.
+// Used to pick anchors that produce as few false candidates as possible.
+constexpr int ByteCommonness(uint8_t b)
+{
+    switch (b)
+    {
+    case 0x00: case 0xFF: case 0xCC: return 10;
+    case 0x8B: case 0x48: case 0x89: return 8;
+    case 0x0F: case 0xE8: case 0x4C: case 0x85: case 0x83: case 0x24: case 0x44: case 0x45: return 6;
+    case 0x01: case 0x04: case 0x08: case 0xC0: case 0xC3: case 0x74: case 0x75: case 0x50: case 0x10: return 4;
+    default: return 1;
+    }
+}
+
+constexpr int HexDigit(char c)
+{
+    return c >= '0' && c <= '9' ? c - '0'
+         : c >= 'A' && c <= 'F' ? c - 'A' + 10
+         : c >= 'a' && c <= 'f' ? c - 'a' + 10
+         : -1;
+}
+
+// Pick the rarest fixed byte as the first anchor and the rarest other fixed
+// byte (preferring a different value) as the second. Returns false when the
+// signature has no fixed bytes at all.
+constexpr bool SelectAnchors(const uint8_t* value, const uint8_t* mask, size_t length, size_t& anchor1, size_t& anchor2)
+{
+    int best1 = INT_MAX, best2 = INT_MAX;
+    anchor1 = 0;
+    for (size_t j = 0; j < length; j++)
+    {
+        if (mask[j] && ByteCommonness(value[j]) < best1)
+        {
+            best1 = ByteCommonness(value[j]);
+            anchor1 = j;
+        }
+    }
+
+    anchor2 = anchor1;
+    for (size_t j = 0; j < length; j++)
+    {
+        if (!mask[j] || j == anchor1)
+            continue;
+
+        int score = ByteCommonness(value[j]) + (value[j] == value[anchor1] ? 4 : 0);
+        if (score < best2)
+        {
+            best2 = score;
+            anchor2 = j;
+        }
+    }
+    return best1 != INT_MAX;
+}
+
+// Non-owning view of a compiled signature: packed value/mask bytes and the
+// anchors used by the vectorized candidate search.
+struct SignatureView
+{
+    const uint8_t* value;
+    const uint8_t* mask;
+    size_t length;
+    size_t anchor1;
+    size_t anchor2;
+    bool hasAnchor;
+    const char* text;   // IDA-style source string
+
+    size_t size() const { return length; }
+
+    bool MatchesAt(const uint8_t* data) const
+    {
+        for (size_t j = 0; j < length; j++)
+        {
+            if ((data[j] & mask[j]) != value[j])
+                return false;
+        }
+        return true;
+    }
+
+    // Bytes that differ from the signature at `data`; wildcards always match
+    size_t Mismatches(const uint8_t* data) const
+    {
+        size_t count = 0;
+        for (size_t j = 0; j < length; j++)
+            count += (data[j] & mask[j]) != value[j];
+        return count;
+    }
+};
+
+// IDA-style signature ("48 8B 0D ? ? ? ?") compiled at build time.
+// A malformed string throws inside a constant expression, which fails the build.
+template<size_t N>
+struct Signature
+{
+    uint8_t value[(N + 1) / 2] = {};
+    uint8_t mask[(N + 1) / 2] = {};
+    size_t length = 0;
+    size_t anchor1 = 0;
+    size_t anchor2 = 0;
+    bool hasAnchor = false;
+
+    constexpr explicit Signature(const char (&text)[N])
+    {
+        size_t i = 0;
+        while (i + 1 < N)
+        {
+            if (text[i] == ' ')
+            {
+                i++;
+                continue;
+            }
+
+            if (text[i] == '?')
+            {
+                i++;
+                if (text[i] == '?')
+                    i++;
+                mask[length++] = 0;
+            }
+            else
+            {
+                int high = HexDigit(text[i++]);
+                if (high < 0)
+                    throw "signature: expected hex byte or '?'";
+
+                int byte = high;
+                if (i + 1 < N && text[i] != ' ')
+                {
+                    int low = HexDigit(text[i++]);
+                    if (low < 0)
+                        throw "signature: expected hex byte or '?'";
+                    byte = high * 16 + low;
+                }
+
+                value[length] = static_cast<uint8_t>(byte);
+                mask[length++] = 0xFF;
+            }
+
+            if (i + 1 < N && text[i] != ' ')
+                throw "signature: bytes must be separated by spaces";
+        }
+
+        hasAnchor = SelectAnchors(value, mask, length, anchor1, anchor2);
+        if (!hasAnchor)
+            throw "signature: needs at least one fixed byte";
+    }
+
+    SignatureView View(const char* text) const
+    {
+        return { value, mask, length, anchor1, anchor2, hasAnchor, text };
+    }
+};
+
+// Compile a signature literal at build time and return a view of its static storage
+#define GMOD_SIG(text) ([]() -> SignatureView { static constexpr Signature<sizeof(text)> sig(text); return sig.View(text); }())
+
+// Signature built at runtime from a PatternToBytes result, for user-supplied strings
+class RuntimeSignature
+{
+public:
+    RuntimeSignature(const std::string& pattern, const std::vector<int>& bytes) : text(pattern)
+    {
+        value.reserve(bytes.size());
+        mask.reserve(bytes.size());
+        for (int b : bytes)
+        {
+            value.push_back(b == -1 ? 0 : static_cast<uint8_t>(b));
+            mask.push_back(b == -1 ? 0 : 0xFF);
+        }
+    }
+
+    RuntimeSignature(const RuntimeSignature&) = delete;
+    RuntimeSignature& operator=(const RuntimeSignature&) = delete;
+
+    SignatureView View() const
+    {
+        SignatureView view = { value.data(), mask.data(), value.size(), 0, 0, false, text.c_str() };
+        view.hasAnchor = SelectAnchors(view.value, view.mask, view.length, view.anchor1, view.anchor2);
+        return view;
+    }
+
+private:
+    std::string text;
+    std::vector<uint8_t> value;
+    std::vector<uint8_t> mask;
+};
+
+static const size_t kNoMatch = SIZE_MAX;
+
+// Work done by the matchers on the calling thread. Candidates are positions
+// that passed the anchor filter; full compares are the masked compares run on
+// them. Build with GMOD_TELEMETRY=0 to take the counting out of the hot loops.
+#ifndef GMOD_TELEMETRY
+#define GMOD_TELEMETRY 1
+#endif
+
+struct ScanCounters
+{
+    uint64_t candidates = 0;
+    uint64_t fullCompares = 0;
+};
+
+inline thread_local ScanCounters threadScanCounters;
+
+// Counts in registers inside a matcher call and adds to the thread totals on exit
+struct LocalScanCounters : ScanCounters
+{
+    ~LocalScanCounters()
+    {
+#if GMOD_TELEMETRY
+        threadScanCounters.candidates += candidates;
+        threadScanCounters.fullCompares += fullCompares;
+#endif
+    }
+};
+
+#if GMOD_TELEMETRY
+#define GMOD_COUNT(counter) (++(counter))
+#else
+#define GMOD_COUNT(counter) ((void)0)
+#endif
+
+inline unsigned LowestSetBit(uint32_t bits)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(bits));
+#endif
+}
+
+inline unsigned LowestSetBit64(uint64_t bits)
+{
+    const uint32_t low = static_cast<uint32_t>(bits);
+    return low ? LowestSetBit(low) : 32 + LowestSetBit(static_cast<uint32_t>(bits >> 32));
+}
+
+// Scalar fallback: memchr for the first anchor, then a full masked compare
+inline size_t FindFirstScalar(const uint8_t* data, size_t size, const SignatureView& pattern)
+{
+    if (size < pattern.size())
+        return kNoMatch;
+
+    const size_t last = size - pattern.size();
+    if (!pattern.hasAnchor)
+        return 0;
+
+    const uint8_t a1 = pattern.value[pattern.anchor1];
+    LocalScanCounters counters;
+    size_t pos = 0;
+    while (pos <= last)
+    {
+        const void* hit = memchr(data + pos + pattern.anchor1, a1, last - pos + 1);
+        if (!hit)
+            break;
+
+        size_t candidate = static_cast<const uint8_t*>(hit) - data - pattern.anchor1;
+        GMOD_COUNT(counters.candidates);
+        if (data[candidate + pattern.anchor2] == pattern.value[pattern.anchor2])
+        {
+            GMOD_COUNT(counters.fullCompares);
+            if (pattern.MatchesAt(data + candidate))
+                return candidate;
+        }
+        pos = candidate + 1;
+    }
+    return kNoMatch;
+}
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define GMOD_HAVE_SIMD 1
+
+#if defined(__GNUC__) || defined(__clang__)
+#define GMOD_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define GMOD_TARGET_AVX2
+#endif
+
+// SSE2: compare both anchors for 16 candidate positions at once
+inline size_t FindFirstSSE2(const uint8_t* data, size_t size, const SignatureView& pattern)
+{
+    if (size < pattern.size() || !pattern.hasAnchor)
+        return FindFirstScalar(data, size, pattern);
+
+    const size_t last = size - pattern.size();
+    const __m128i v1 = _mm_set1_epi8(static_cast<char>(pattern.value[pattern.anchor1]));
+    const __m128i v2 = _mm_set1_epi8(static_cast<char>(pattern.value[pattern.anchor2]));
+
+    LocalScanCounters counters;
+    size_t pos = 0;
+    for (; pos + 16 <= last + 1; pos += 16)
+    {
+        __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + pattern.anchor1));
+        __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos + pattern.anchor2));
+        unsigned bits = static_cast<unsigned>(_mm_movemask_epi8(
+            _mm_and_si128(_mm_cmpeq_epi8(b1, v1), _mm_cmpeq_epi8(b2, v2))));
+
+        while (bits)
+        {
+            unsigned bit = LowestSetBit(bits);
+            GMOD_COUNT(counters.candidates);
+            GMOD_COUNT(counters.fullCompares);
+            if (pattern.MatchesAt(data + pos + bit))
+                return pos + bit;
+            bits &= bits - 1;
+        }
+    }
+
+    size_t tail = FindFirstScalar(data + pos, size - pos, pattern);
+    return tail == kNoMatch ? kNoMatch : pos + tail;
+}
+
+// AVX2: same as SSE2 but 32 candidate positions per iteration
+GMOD_TARGET_AVX2 inline size_t FindFirstAVX2(const uint8_t* data, size_t size, const SignatureView& pattern)
+{
+    if (size < pattern.size() || !pattern.hasAnchor)
+        return FindFirstScalar(data, size, pattern);
+
+    const size_t last = size - pattern.size();
+    const __m256i v1 = _mm256_set1_epi8(static_cast<char>(pattern.value[pattern.anchor1]));
+    const __m256i v2 = _mm256_set1_epi8(static_cast<char>(pattern.value[pattern.anchor2]));
+
+    LocalScanCounters counters;
+    size_t pos = 0;
+    for (; pos + 32 <= last + 1; pos += 32)
+    {
+        __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + pattern.anchor1));
+        __m256i b2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + pattern.anchor2));
+        uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(
+            _mm256_and_si256(_mm256_cmpeq_epi8(b1, v1), _mm256_cmpeq_epi8(b2, v2))));
+
+        while (bits)
+        {
+            unsigned bit = LowestSetBit(bits);
+            GMOD_COUNT(counters.candidates);
+            GMOD_COUNT(counters.fullCompares);
+            if (pattern.MatchesAt(data + pos + bit))
+                return pos + bit;
+            bits &= bits - 1;
+        }
+    }
+
+    size_t tail = FindFirstSSE2(data + pos, size - pos, pattern);
+    return tail == kNoMatch ? kNoMatch : pos + tail;
+}
+
+// AVX2 prefilter for MultiPatternScanner: bit k of masks[n] is set when the
+// byte pair at 32 * n + k may be an anchor. `filter` holds one bit per bucket
+// of anchors for each low and high nibble of the first byte, then of the
+// second; a pair whose four lookups share a bucket is a candidate. `count` is
+// a multiple of 32 and data[count] must be readable.
+GMOD_TARGET_AVX2 inline void AnchorCandidatesAVX2(const uint8_t* data, size_t count, const uint8_t (&filter)[4][16], uint32_t* masks)
+{
+    const __m256i low1 = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(filter[0])));
+    const __m256i high1 = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(filter[1])));
+    const __m256i low2 = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(filter[2])));
+    const __m256i high2 = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(filter[3])));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+    for (size_t pos = 0; pos < count; pos += 32)
+    {
+        const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        const __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + 1));
+        __m256i buckets = _mm256_and_si256(_mm256_shuffle_epi8(low1, _mm256_and_si256(first, nibble)),
+                                           _mm256_shuffle_epi8(high1, _mm256_and_si256(_mm256_srli_epi16(first, 4), nibble)));
+        buckets = _mm256_and_si256(buckets, _mm256_shuffle_epi8(low2, _mm256_and_si256(second, nibble)));
+        buckets = _mm256_and_si256(buckets, _mm256_shuffle_epi8(high2, _mm256_and_si256(_mm256_srli_epi16(second, 4), nibble)));
+        masks[pos / 32] = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(buckets, _mm256_setzero_si256())));
+    }
+}
+
+inline bool CpuHasAVX2()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+
+typedef size_t (*FindFirstFn)(const uint8_t* data, size_t size, const SignatureView& pattern);
+
+// Widest scan routine the CPU supports, chosen once at startup
+inline FindFirstFn SelectFindFirst(const char** name = nullptr)
+{
+#ifdef GMOD_HAVE_SIMD
+    if (CpuHasAVX2())
+    {
+        if (name) *name = "AVX2";
+        return FindFirstAVX2;
+    }
+    if (name) *name = "SSE2";
+    return FindFirstSSE2;
+#else
+    if (name) *name = "scalar";
+    return FindFirstScalar;
+#endif
+}
+
+static const FindFirstFn FindFirst = SelectFindFirst();
+
+// Matches a whole set of IDA-style signatures in a single pass over a buffer.
+// Each pattern is indexed by its rarest pair of adjacent fixed bytes; the scan
+// looks byte pairs up in that table and only verifies the patterns whose
+// anchor matched. With AVX2 a nibble filter over 32 pairs at a time picks
+// the pairs worth looking up, so most of the buffer never reaches the table.
+class MultiPatternScanner
+{
+public:
+    // Add a compiled signature, returns its ID. The view's bytes must
+    // outlive the scanner.
+    size_t AddPattern(const SignatureView& pattern)
+    {
+        patterns.push_back(pattern);
+        compiled = false;
+        return patterns.size() - 1;
+    }
+
+    size_t PatternCount() const { return patterns.size(); }
+
+    size_t MaxPatternLength() const
+    {
+        size_t length = 0;
+        for (const auto& pattern : patterns)
+            length = std::max(length, pattern.size());
+        return length;
+    }
+
+    // Build the anchor table
+    void Compile()
+    {
+        std::vector<std::vector<Entry>> buckets(65536);
+        unanchored.clear();
+        anchorBits.assign(65536 / 64, 0);
+
+        for (size_t id = 0; id < patterns.size(); id++)
+        {
+            const auto& pattern = patterns[id];
+            int bestScore = INT_MAX;
+            size_t bestOffset = 0;
+
+            for (size_t j = 0; j + 1 < pattern.size(); j++)
+            {
+                if (!pattern.mask[j] || !pattern.mask[j + 1])
+                    continue;
+
+                int score = ByteCommonness(pattern.value[j]) + ByteCommonness(pattern.value[j + 1]);
+                if (score < bestScore)
+                {
+                    bestScore = score;
+                    bestOffset = j;
+                }
+            }
+
+            if (bestScore == INT_MAX)
+            {
+                unanchored.push_back(static_cast<uint32_t>(id));
+                continue;
+            }
+
+            uint16_t key = static_cast<uint16_t>(pattern.value[bestOffset] | (pattern.value[bestOffset + 1] << 8));
+            buckets[key].push_back({ static_cast<uint32_t>(id), static_cast<uint32_t>(bestOffset) });
+            anchorBits[key >> 6] |= 1ull << (key & 63);
+        }
+
+        // Flatten buckets into one contiguous array
+        bucketStart.assign(65537, 0);
+        entries.clear();
+        for (size_t key = 0; key < 65536; key++)
+        {
+            bucketStart[key] = static_cast<uint32_t>(entries.size());
+            entries.insert(entries.end(), buckets[key].begin(), buckets[key].end());
+        }
+        bucketStart[65536] = static_cast<uint32_t>(entries.size());
+        CompileFilter();
+        compiled = true;
+    }
+
+    // Scan a buffer, calling onHit(patternId, offset) for every match.
+    // Matches are reported in increasing offset order for any single pattern.
+    template<typename Callback>
+    void Scan(const uint8_t* data, size_t size, Callback&& onHit) const
+    {
+        if (!compiled || size < 2)
+            return;
+
+        LocalScanCounters counters;
+        size_t i = 0;
+#ifdef GMOD_HAVE_SIMD
+        if (filterEnabled)
+        {
+            // Blocks of 4096 pairs; the pair at size - 1 has no second byte
+            uint32_t masks[4096 / 32];
+            for (size_t count; (count = std::min<size_t>(4096, (size - 1 - i) & ~size_t(31))) != 0; i += count)
+            {
+                AnchorCandidatesAVX2(data + i, count, filter, masks);
+                for (size_t m = 0; m < count / 32; m++)
+                {
+                    for (uint32_t bits = masks[m]; bits; bits &= bits - 1)
+                        CheckAnchor(data, size, i + 32 * m + LowestSetBit(bits), onHit, counters);
+                }
+            }
+        }
+#endif
+        for (; i + 1 < size; i++)
+            CheckAnchor(data, size, i, onHit, counters);
+
+        for (uint32_t id : unanchored)
+        {
+            for (size_t start = 0; start < size; start++)
+            {
+                if (Matches(patterns[id], data, size, start))
+                    onHit(static_cast<size_t>(id), start);
+            }
+        }
+    }
+
+private:
+    struct Entry
+    {
+        uint32_t patternId;
+        uint32_t anchorOffset;
+    };
+
+    static bool Matches(const SignatureView& pattern, const uint8_t* data, size_t size, size_t start)
+    {
+        return start + pattern.size() <= size && pattern.MatchesAt(data + start);
+    }
+
+    // Look up the byte pair at `i` and verify the patterns anchored on it
+    template<typename Callback>
+    void CheckAnchor(const uint8_t* data, size_t size, size_t i, Callback& onHit, LocalScanCounters& counters) const
+    {
+        uint16_t key = static_cast<uint16_t>(data[i] | (data[i + 1] << 8));
+        if (!(anchorBits[key >> 6] & (1ull << (key & 63))))
+            return;
+
+        for (uint32_t e = bucketStart[key]; e < bucketStart[key + 1]; e++)
+        {
+            const Entry& entry = entries[e];
+            GMOD_COUNT(counters.candidates);
+            if (i < entry.anchorOffset)
+                continue;
+
+            size_t start = i - entry.anchorOffset;
+            GMOD_COUNT(counters.fullCompares);
+            if (Matches(patterns[entry.patternId], data, size, start))
+                onHit(static_cast<size_t>(entry.patternId), start);
+        }
+    }
+
+    // Spread the anchor pairs over the filter's 8 buckets. A bucket accepts
+    // every pair made of its nibbles, so each pair goes where it adds the
+    // fewest pairs that are not anchors.
+    void CompileFilter()
+    {
+        memset(filter, 0, sizeof(filter));
+        filterEnabled = false;
+#ifdef GMOD_HAVE_SIMD
+        if (entries.empty() || !CpuHasAVX2())
+            return;
+
+        uint16_t nibbles[8][4] = {};
+        auto accepted = [](const uint16_t (&sets)[4])
+        {
+            size_t count = 1;
+            for (uint16_t set : sets)
+                count *= PopCount16(set);
+            return count;
+        };
+        for (size_t key = 0; key < 65536; key++)
+        {
+            if (bucketStart[key] == bucketStart[key + 1])
+                continue;
+
+            const uint8_t parts[4] = { static_cast<uint8_t>(key & 15), static_cast<uint8_t>((key >> 4) & 15),
+                                       static_cast<uint8_t>((key >> 8) & 15), static_cast<uint8_t>(key >> 12) };
+            size_t best = 0, bestCost = SIZE_MAX;
+            for (size_t bucket = 0; bucket < 8; bucket++)
+            {
+                uint16_t grown[4];
+                for (size_t t = 0; t < 4; t++)
+                    grown[t] = nibbles[bucket][t] | static_cast<uint16_t>(1u << parts[t]);
+                const size_t cost = accepted(grown) - accepted(nibbles[bucket]);
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    best = bucket;
+                }
+            }
+            for (size_t t = 0; t < 4; t++)
+            {
+                nibbles[best][t] |= static_cast<uint16_t>(1u << parts[t]);
+                filter[t][parts[t]] |= static_cast<uint8_t>(1u << best);
+            }
+        }
+        filterEnabled = true;
+#endif
+    }
+
+    static size_t PopCount16(uint16_t bits)
+    {
+        size_t count = 0;
+        for (; bits; bits &= bits - 1)
+            count++;
+        return count;
+    }
+
+    std::vector<SignatureView> patterns;
+    std::vector<uint64_t> anchorBits;
+    std::vector<uint32_t> bucketStart;
+    std::vector<Entry> entries;
+    std::vector<uint32_t> unanchored;
+    uint8_t filter[4][16] = {};     // AVX2 prefilter: bucket bits per nibble, see CompileFilter
+    bool filterEnabled = false;
+    bool compiled = false;
+};
+
+// Finds every position where a signature matches with at most k differing
+// bytes (Hamming distance; wildcards always match). Two kernels:
+//  - Pigeonhole filter: the fixed bytes are split into k + 1 pieces, one of
+//    which must match exactly, so the vectorized exact search finds the
+//    candidates and only those are compared. Used when every piece keeps
+//    enough fixed bytes to be selective.
+//  - Wu and Manber's bit-parallel Shift-Or otherwise: one 64-bit state per
+//    mismatch count, so a byte costs k + 1 shift/or/and steps.
+class ApproximateMatcher
+{
+public:
+    static const size_t kMaxLength = 64;
+    static const size_t kMaxMismatches = 7;
+    static const size_t kMinPieceBytes = 3;
+
+    ApproximateMatcher() {}
+    ApproximateMatcher(const ApproximateMatcher&) = delete;
+    ApproximateMatcher& operator=(const ApproximateMatcher&) = delete;
+
+    // False if the pattern is too long, or has no more fixed bytes than
+    // allowed mismatches and would match everywhere
+    bool Compile(const SignatureView& pattern, size_t maxMismatches)
+    {
+        length = pattern.size();
+        mismatches = maxMismatches;
+        size_t fixed = 0;
+        for (size_t j = 0; j < length; j++)
+            fixed += pattern.mask[j] != 0;
+        if (!length || length > kMaxLength || maxMismatches > kMaxMismatches || fixed <= maxMismatches)
+            return false;
+
+        value.assign(pattern.value, pattern.value + length);
+        mask.assign(pattern.mask, pattern.mask + length);
+
+        // Bit j of table[c] is set when byte c does not fit pattern position j
+        for (size_t c = 0; c < 256; c++)
+        {
+            uint64_t bits = 0;
+            for (size_t j = 0; j < length; j++)
+            {
+                if ((c & mask[j]) != value[j])
+                    bits |= 1ull << j;
+            }
+            table[c] = bits;
+        }
+
+        // Split the fixed bytes as evenly as possible into k + 1 pieces
+        pieces.clear();
+        if (fixed / (maxMismatches + 1) >= kMinPieceBytes)
+        {
+            size_t begin = 0;
+            for (size_t piece = 0; piece <= maxMismatches; piece++)
+            {
+                size_t quota = fixed / (maxMismatches + 1) + (piece < fixed % (maxMismatches + 1) ? 1 : 0);
+                size_t end = begin;
+                for (size_t taken = 0; end < length && (taken < quota || piece == maxMismatches); end++)
+                    taken += mask[end] != 0;
+
+                // Wildcards at either end of a piece filter nothing
+                size_t first = begin, last = end;
+                while (!mask[first])
+                    first++;
+                while (!mask[last - 1])
+                    last--;
+
+                Piece entry;
+                entry.offset = first;
+                entry.view = { value.data() + first, mask.data() + first, last - first, 0, 0, false, "" };
+                entry.view.hasAnchor = SelectAnchors(entry.view.value, entry.view.mask, entry.view.length,
+                                                     entry.view.anchor1, entry.view.anchor2);
+                pieces.push_back(entry);
+                begin = end;
+            }
+        }
+        return true;
+    }
+
+    size_t Length() const { return length; }
+
+    // Whether scans use the pigeonhole filter rather than Shift-Or
+    bool Filtered() const { return !pieces.empty(); }
+
+    // Scan a buffer, calling onHit(start, distance) for every position within
+    // the allowed mismatches, in increasing start order
+    template<typename Callback>
+    void Scan(const uint8_t* data, size_t size, Callback&& onHit) const
+    {
+        if (!pieces.empty())
+        {
+            ScanPieces(data, size, onHit);
+            return;
+        }
+
+        switch (mismatches)
+        {
+        case 0: ScanWith<0>(data, size, onHit); break;
+        case 1: ScanWith<1>(data, size, onHit); break;
+        case 2: ScanWith<2>(data, size, onHit); break;
+        case 3: ScanWith<3>(data, size, onHit); break;
+        case 4: ScanWith<4>(data, size, onHit); break;
+        case 5: ScanWith<5>(data, size, onHit); break;
+        case 6: ScanWith<6>(data, size, onHit); break;
+        default: ScanWith<7>(data, size, onHit); break;
+        }
+    }
+
+private:
+    struct Piece
+    {
+        size_t offset;          // of the piece within the pattern
+        SignatureView view;
+    };
+
+    template<typename Callback>
+    void ScanPieces(const uint8_t* data, size_t size, Callback& onHit) const
+    {
+        std::vector<size_t> starts;
+        for (const Piece& piece : pieces)
+        {
+            for (size_t pos = 0; pos < size;)
+            {
+                size_t i = FindFirst(data + pos, size - pos, piece.view);
+                if (i == kNoMatch)
+                    break;
+                size_t hit = pos + i;
+                pos = hit + 1;
+                if (hit >= piece.offset && hit - piece.offset + length <= size)
+                    starts.push_back(hit - piece.offset);
+            }
+        }
+
+        // A site matching several pieces is found once per piece
+        std::sort(starts.begin(), starts.end());
+        starts.erase(std::unique(starts.begin(), starts.end()), starts.end());
+
+        LocalScanCounters counters;
+        for (size_t start : starts)
+        {
+            GMOD_COUNT(counters.fullCompares);
+            size_t distance = 0;
+            for (size_t j = 0; j < length && distance <= mismatches; j++)
+                distance += (data[start + j] & mask[j]) != value[j];
+            if (distance <= mismatches)
+                onHit(start, distance);
+        }
+    }
+
+    // state[d] bit j is clear when the last j + 1 bytes match the first
+    // j + 1 pattern bytes with at most d mismatches
+    template<size_t K, typename Callback>
+    void ScanWith(const uint8_t* data, size_t size, Callback& onHit) const
+    {
+        uint64_t state[K + 1];
+        std::fill(state, state + K + 1, ~0ull);
+        const uint64_t last = 1ull << (length - 1);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            const uint64_t bits = table[data[i]];
+            uint64_t previous = state[0];
+            state[0] = (state[0] << 1) | bits;
+            for (size_t d = 1; d <= K; d++)
+            {
+                uint64_t current = state[d];
+                state[d] = ((current << 1) | bits) & (previous << 1);
+                previous = current;
+            }
+
+            if (!(state[K] & last))
+            {
+                size_t distance = 0;
+                while (state[distance] & last)
+                    distance++;
+                onHit(i + 1 - length, distance);
+            }
+        }
+    }
+
+    uint64_t table[256] = {};
+    std::vector<uint8_t> value;
+    std::vector<uint8_t> mask;
+    std::vector<Piece> pieces;
+    size_t length = 0;
+    size_t mismatches = 0;
+};
+
+// Section table entry of a PE image
+struct PESection
+{
+    std::string name;
+    uint32_t rva = 0;
+    uint32_t virtualSize = 0;
+    uint32_t rawOffset = 0;
+    uint32_t rawSize = 0;
+    uint32_t characteristics = 0;
+};
+
+// The parts of the PE headers the scanner cares about
+struct PEHeaderInfo
+{
+    uint16_t machine = 0;
+    uint32_t timeDateStamp = 0;
+    uint64_t imageBase = 0;
+    uint32_t sizeOfImage = 0;
+    uint32_t sizeOfHeaders = 0;
+    bool is64 = false;
+    uint32_t relocationRva = 0;     // base relocation directory
+    uint32_t relocationSize = 0;
+    uint32_t exceptionRva = 0;      // x64 function table (.pdata)
+    uint32_t exceptionSize = 0;
+    std::vector<PESection> sections;
+};
+
+// Section characteristics used for scan planning
+const uint32_t kSectionCode = 0x00000020;
+const uint32_t kSectionInitializedData = 0x00000040;
+const uint32_t kSectionUninitializedData = 0x00000080;
+const uint32_t kSectionExecute = 0x20000000;
+const uint32_t kSectionWrite = 0x80000000;
+
+// A contiguous address range to scan
+struct ScanRange
+{
+    uintptr_t start;
+    size_t size;
+};
+
+// Append [start, end) to a sorted range list, merging it into the last
+// range when they touch
+inline void AppendRange(std::vector<ScanRange>& ranges, uintptr_t start, uintptr_t end)
+{
+    if (start >= end)
+        return;
+    if (!ranges.empty() && ranges.back().start + ranges.back().size >= start)
+    {
+        ScanRange& last = ranges.back();
+        last.size = std::max<uintptr_t>(last.start + last.size, end) - last.start;
+        return;
+    }
+    ranges.push_back({ start, end - start });
+}
+
+// One unit of parallel scan work: an owned slice of a range plus overlap
+struct ScanTask
+{
+    uintptr_t address;
+    size_t ownedSize;
+    size_t readSize;
+    size_t offset;      // from the module base
+};
+
+// Lower `target` to `value` if it is smaller
+inline void AtomicMin(std::atomic<size_t>& target, size_t value)
+{
+    size_t current = target.load();
+    while (value < current && !target.compare_exchange_weak(current, value))
+    {
+    }
+}
+
+// Match RVAs of many patterns in one flat array: grouped by pattern ID and
+// sorted within each group, with start[id]..start[id + 1] marking a group
+struct MatchList
+{
+    struct Span
+    {
+        const uint32_t* rvas;
+        size_t count;
+    };
+
+    std::vector<uint32_t> start;
+    std::vector<uint32_t> rvas;
+
+    Span Of(size_t id) const
+    {
+        if (id + 1 >= start.size())
+            return { nullptr, 0 };
+        return { rvas.data() + start[id], start[id + 1] - start[id] };
+    }
+
+    // Counting sort of packed (pattern ID << 32 | RVA) lists. The lists must
+    // be in address order for each pattern; that order is kept.
+    void Build(size_t patternCount, const std::vector<std::vector<uint64_t>>& lists)
+    {
+        start.assign(patternCount + 1, 0);
+        for (const auto& list : lists)
+        {
+            for (uint64_t match : list)
+                start[(match >> 32) + 1]++;
+        }
+        for (size_t id = 0; id < patternCount; id++)
+            start[id + 1] += start[id];
+
+        rvas.resize(start[patternCount]);
+        std::vector<uint32_t> next(start.begin(), start.end() - 1);
+        for (const auto& list : lists)
+        {
+            for (uint64_t match : list)
+                rvas[next[match >> 32]++] = static_cast<uint32_t>(match);
+        }
+    }
+};
+
+// Parse DOS/NT headers and the section table from the first bytes of an image
+inline bool ParsePEHeaders(const uint8_t* data, size_t size, PEHeaderInfo& info)
+{
+    auto u16 = [&](size_t at) { uint16_t v; memcpy(&v, data + at, 2); return v; };
+    auto u32 = [&](size_t at) { uint32_t v; memcpy(&v, data + at, 4); return v; };
+
+    if (size < 0x40 || data[0] != 'M' || data[1] != 'Z')
+        return false;
+
+    size_t nt = u32(0x3C);
+    if (nt + 24 > size || memcmp(data + nt, "PE\0\0", 4) != 0)
+        return false;
+
+    size_t fileHeader = nt + 4;
+    info.machine = u16(fileHeader);
+    uint16_t sectionCount = u16(fileHeader + 2);
+    info.timeDateStamp = u32(fileHeader + 4);
+    uint16_t optionalSize = u16(fileHeader + 16);
+
+    size_t optional = fileHeader + 20;
+    if (optional + 64 > size)
+        return false;
+
+    uint16_t magic = u16(optional);
+    size_t directories = 0;
+    if (magic == 0x20B)
+    {
+        memcpy(&info.imageBase, data + optional + 24, 8);
+        directories = optional + 112;
+    }
+    else if (magic == 0x10B)
+    {
+        info.imageBase = u32(optional + 28);
+        directories = optional + 96;
+    }
+    else
+    {
+        return false;
+    }
+    info.is64 = magic == 0x20B;
+    info.sizeOfImage = u32(optional + 56);
+    info.sizeOfHeaders = u32(optional + 60);
+
+    // Data directory 3: exception table, 5: base relocations
+    const size_t exception = directories + 3 * 8;
+    info.exceptionRva = info.exceptionSize = 0;
+    if (exception + 8 <= optional + optionalSize && exception + 8 <= size && u32(directories - 4) > 3)
+    {
+        info.exceptionRva = u32(exception);
+        info.exceptionSize = u32(exception + 4);
+    }
+
+    const size_t relocation = directories + 5 * 8;
+    info.relocationRva = info.relocationSize = 0;
+    if (relocation + 8 <= optional + optionalSize && relocation + 8 <= size && u32(directories - 4) > 5)
+    {
+        info.relocationRva = u32(relocation);
+        info.relocationSize = u32(relocation + 4);
+    }
+
+    size_t table = optional + optionalSize;
+    info.sections.clear();
+    for (uint16_t i = 0; i < sectionCount && table + (i + 1) * 40 <= size; i++)
+    {
+        size_t at = table + i * 40;
+        PESection section;
+        section.name.assign(reinterpret_cast<const char*>(data + at), strnlen(reinterpret_cast<const char*>(data + at), 8));
+        section.virtualSize = u32(at + 8);
+        section.rva = u32(at + 12);
+        section.rawSize = u32(at + 16);
+        section.rawOffset = u32(at + 20);
+        section.characteristics = u32(at + 36);
+        info.sections.push_back(section);
+    }
+    return true;
+}
+
+// Operand layout of one x86/x64 instruction, as far as signatures care:
+// where its memory displacement and immediate are and what they mean
+struct DecodedInstruction
+{
+    uint8_t length = 0;
+    uint8_t dispOffset = 0;         // ModRM displacement or moffs, size 0 if none
+    uint8_t dispSize = 0;
+    uint8_t immOffset = 0;          // immediate or branch displacement, size 0 if none
+    uint8_t immSize = 0;
+    bool ripRelative = false;       // [rip + disp32]: relative to the next instruction
+    bool absoluteAddress = false;   // [disp32] or moffs: an absolute address
+    bool segmentBase = false;       // FS/GS override: the address is thread-relative
+    bool relativeBranch = false;    // the immediate is a jmp/jcc/call/loop displacement
+    uint8_t opcode = 0;             // last opcode byte, in opcodeMap
+    uint8_t opcodeMap = 0;          // 0 one-byte, 1 0F, 2 0F38, 3 0F3A, VEX/EVEX maps as encoded
+    uint8_t operandSize = 4;        // general-purpose operand size: 2, 4 or 8 (REX.W) bytes
+};
+
+// Length decoder for x86 and x64 code: legacy prefixes, REX, VEX/EVEX, the
+// one-byte and 0F/0F38/0F3A maps, ModRM/SIB, displacements and immediates.
+// Returns false for truncated or invalid encodings.
+inline bool DecodeInstruction(const uint8_t* code, size_t size, bool x64, DecodedInstruction& out)
+{
+    out = DecodedInstruction();
+    const size_t limit = std::min<size_t>(size, 15);
+    size_t pos = 0;
+    bool operand16 = false, addressOverride = false, rexW = false;
+
+    for (; pos < limit; pos++)
+    {
+        uint8_t b = code[pos];
+        if (b == 0x64 || b == 0x65)
+            out.segmentBase = true;
+        if (b == 0x66)
+            operand16 = true;
+        else if (b == 0x67)
+            addressOverride = true;
+        else if (b != 0xF0 && b != 0xF2 && b != 0xF3 && b != 0x2E && b != 0x36 && b != 0x3E && b != 0x26 && b != 0x64 && b != 0x65)
+            break;
+    }
+    if (x64 && pos < limit && (code[pos] & 0xF0) == 0x40)
+        rexW = (code[pos++] & 0x08) != 0;
+    if (pos >= limit)
+        return false;
+
+    const size_t z = operand16 ? 2 : 4;
+    uint8_t opcode = code[pos++];
+    int map = 0;
+    bool modrm = false;
+    size_t imm = 0;
+    bool branch = false;
+
+    // 0F-map opcodes with an imm8, in legacy and VEX/EVEX encodings alike
+    static const uint8_t withImm8[] = { 0x0F, 0x70, 0x71, 0x72, 0x73, 0xA4, 0xAC, 0xBA, 0xC2, 0xC4, 0xC5, 0xC6 };
+    auto hasImm8 = [](uint8_t op) { return std::find(std::begin(withImm8), std::end(withImm8), op) != std::end(withImm8); };
+
+    // VEX (C4/C5) and EVEX (62); in 32-bit code only when the next byte
+    // would be a register ModRM, otherwise they are LES/LDS/BOUND
+    if ((opcode == 0xC4 || opcode == 0xC5 || opcode == 0x62) && pos < limit && (x64 || (code[pos] & 0xC0) == 0xC0))
+    {
+        size_t prefixBytes = opcode == 0xC5 ? 1 : opcode == 0xC4 ? 2 : 3;
+        if (pos + prefixBytes >= limit)
+            return false;
+        map = opcode == 0xC5 ? 1 : code[pos] & (opcode == 0x62 ? 0x07 : 0x1F);
+        if (map < 1 || map > 6 || (opcode != 0x62 && map > 3))
+            return false;
+        pos += prefixBytes;
+        opcode = code[pos++];
+        modrm = !(map == 1 && opcode == 0x77);  // vzeroupper/vzeroall
+        imm = map == 3 || (map == 1 && hasImm8(opcode)) ? 1 : 0;
+    }
+    else if (opcode == 0x0F)
+    {
+        if (pos >= limit)
+            return false;
+        opcode = code[pos++];
+        if (opcode == 0x38 || opcode == 0x3A)
+        {
+            map = opcode == 0x38 ? 2 : 3;
+            if (pos >= limit)
+                return false;
+            opcode = code[pos++];
+            modrm = true;
+            imm = map == 3 ? 1 : 0;
+        }
+        else
+        {
+            map = 1;
+            if ((opcode & 0xF0) == 0x80)
+            {
+                imm = x64 ? 4 : z;  // jcc rel32
+                branch = true;
+            }
+            else
+            {
+                static const uint8_t noModrm[] = { 0x05, 0x06, 0x07, 0x08, 0x09, 0x0B, 0x0E, 0x30, 0x31, 0x32, 0x33,
+                                                   0x34, 0x35, 0x37, 0x77, 0xA0, 0xA1, 0xA2, 0xA8, 0xA9, 0xAA };
+                modrm = (opcode & 0xF8) != 0xC8 && std::find(std::begin(noModrm), std::end(noModrm), opcode) == std::end(noModrm);
+                if (hasImm8(opcode))
+                    imm = 1;
+            }
+        }
+    }
+    else
+    {
+        // Opcodes that do not exist in 64-bit mode
+        static const uint8_t invalid64[] = { 0x06, 0x07, 0x0E, 0x16, 0x17, 0x1E, 0x1F, 0x27, 0x2F, 0x37, 0x3F,
+                                             0x60, 0x61, 0x82, 0x9A, 0xCE, 0xD4, 0xD5, 0xD6, 0xEA };
+        if (x64 && std::find(std::begin(invalid64), std::end(invalid64), opcode) != std::end(invalid64))
+            return false;
+
+        const uint8_t low = opcode & 7;
+        if (opcode < 0x40 && low < 4)
+            modrm = true;                           // ALU r/m forms
+        else if (opcode < 0x40 && low == 4)
+            imm = 1;                                // ALU al, imm8
+        else if (opcode < 0x40 && low == 5)
+            imm = z;                                // ALU eax, imm32
+        else if ((opcode & 0xF0) == 0x70 || (opcode >= 0xE0 && opcode <= 0xE3) || opcode == 0xEB)
+        {
+            imm = 1;
+            branch = true;
+        }
+        else if (opcode == 0xE8 || opcode == 0xE9)
+        {
+            imm = x64 ? 4 : z;
+            branch = true;
+        }
+        else if (opcode >= 0xA0 && opcode <= 0xA3)
+        {
+            // mov with a memory offset: an absolute address the size of a pointer
+            out.dispOffset = static_cast<uint8_t>(pos);
+            out.dispSize = static_cast<uint8_t>(x64 ? (addressOverride ? 4 : 8) : (addressOverride ? 2 : 4));
+            out.absoluteAddress = true;
+            pos += out.dispSize;
+        }
+        else if (opcode >= 0xB8 && opcode <= 0xBF)
+            imm = rexW ? 8 : z;
+        else if ((opcode >= 0xB0 && opcode <= 0xB7) || opcode == 0x6A || opcode == 0xA8 || opcode == 0xCD ||
+                 opcode == 0xD4 || opcode == 0xD5 || (opcode >= 0xE4 && opcode <= 0xE7))
+            imm = 1;
+        else if (opcode == 0x68 || opcode == 0xA9)
+            imm = z;
+        else if (opcode == 0xC2 || opcode == 0xCA)
+            imm = 2;
+        else if (opcode == 0xC8)
+            imm = 3;
+        else if (opcode == 0x9A || opcode == 0xEA)
+            imm = z + 2;
+        else if (opcode == 0x69 || opcode == 0x81 || opcode == 0xC7)
+        {
+            modrm = true;
+            imm = z;
+        }
+        else if (opcode == 0x6B || opcode == 0x80 || opcode == 0x82 || opcode == 0x83 || opcode == 0xC0 ||
+                 opcode == 0xC1 || opcode == 0xC6)
+        {
+            modrm = true;
+            imm = 1;
+        }
+        else if (opcode == 0x62 || opcode == 0x63 || (opcode >= 0x84 && opcode <= 0x8F) || opcode == 0xC4 ||
+                 opcode == 0xC5 || (opcode >= 0xD0 && opcode <= 0xD3) || (opcode >= 0xD8 && opcode <= 0xDF) ||
+                 opcode == 0xF6 || opcode == 0xF7 || opcode == 0xFE || opcode == 0xFF)
+            modrm = true;
+    }
+
+    if (modrm)
+    {
+        if (pos >= limit)
+            return false;
+        const uint8_t m = code[pos++];
+        const uint8_t reg = (m >> 3) & 7, rm = m & 7;
+
+        // mov to/from control and debug registers ignores mod
+        const uint8_t mod = map == 1 && opcode >= 0x20 && opcode <= 0x23 ? 3 : m >> 6;
+
+        // test r/m, imm is the only F6/F7 form with an immediate
+        if (map == 0 && (opcode == 0xF6 || opcode == 0xF7) && reg < 2)
+            imm = opcode == 0xF6 ? 1 : z;
+
+        if (mod != 3)
+        {
+            size_t disp = 0;
+            if (!x64 && addressOverride)
+            {
+                // 16-bit addressing
+                if (mod == 0 && rm == 6)
+                {
+                    disp = 2;
+                    out.absoluteAddress = true;
+                }
+                else
+                    disp = mod == 1 ? 1 : mod == 2 ? 2 : 0;
+            }
+            else
+            {
+                if (rm == 4)
+                {
+                    if (pos >= limit)
+                        return false;
+                    if (mod == 0 && (code[pos] & 7) == 5)
+                    {
+                        disp = 4;
+                        out.absoluteAddress = ((code[pos] >> 3) & 7) == 4;  // no index either
+                    }
+                    pos++;
+                }
+                else if (mod == 0 && rm == 5)
+                {
+                    disp = 4;
+                    out.ripRelative = x64;
+                    out.absoluteAddress = !x64;
+                }
+                if (mod == 1)
+                    disp = 1;
+                else if (mod == 2)
+                    disp = 4;
+            }
+            out.dispOffset = static_cast<uint8_t>(pos);
+            out.dispSize = static_cast<uint8_t>(disp);
+            pos += disp;
+        }
+    }
+
+    if (imm)
+    {
+        out.immOffset = static_cast<uint8_t>(pos);
+        out.immSize = static_cast<uint8_t>(imm);
+        out.relativeBranch = branch;
+        pos += imm;
+    }
+
+    if (pos > limit)
+        return false;
+    out.length = static_cast<uint8_t>(pos);
+    out.opcode = opcode;
+    out.opcodeMap = static_cast<uint8_t>(map);
+    out.operandSize = static_cast<uint8_t>(rexW ? 8 : z);
+    return true;
+}
+
+// Suffix array of s[0..n) by induced sorting (SA-IS), linear time.
+// Symbols must be in [0, upper].
+template<typename Symbol>
+std::vector<int32_t> BuildSuffixArray(const Symbol* s, int32_t n, int32_t upper)
+{
+    if (n == 0)
+        return {};
+    if (n == 1)
+        return { 0 };
+    if (n == 2)
+        return s[0] < s[1] ? std::vector<int32_t>{ 0, 1 } : std::vector<int32_t>{ 1, 0 };
+
+    // S-type (true) or L-type suffixes, and bucket starts for both
+    std::vector<int32_t> sa(n);
+    std::vector<bool> isS(n);
+    for (int32_t i = n - 2; i >= 0; i--)
+        isS[i] = s[i] == s[i + 1] ? isS[i + 1] : s[i] < s[i + 1];
+
+    std::vector<int32_t> sumL(upper + 1), sumS(upper + 1);
+    for (int32_t i = 0; i < n; i++)
+    {
+        if (!isS[i])
+            sumS[s[i]]++;
+        else
+            sumL[s[i] + 1]++;
+    }
+    for (int32_t i = 0; i <= upper; i++)
+    {
+        sumS[i] += sumL[i];
+        if (i < upper)
+            sumL[i + 1] += sumS[i];
+    }
+
+    auto induce = [&](const std::vector<int32_t>& lms)
+    {
+        std::fill(sa.begin(), sa.end(), -1);
+        std::vector<int32_t> bucket(sumS);
+        for (int32_t d : lms)
+        {
+            if (d != n)
+                sa[bucket[s[d]]++] = d;
+        }
+        bucket = sumL;
+        sa[bucket[s[n - 1]]++] = n - 1;
+        for (int32_t i = 0; i < n; i++)
+        {
+            int32_t v = sa[i];
+            if (v >= 1 && !isS[v - 1])
+                sa[bucket[s[v - 1]]++] = v - 1;
+        }
+        bucket = sumL;
+        for (int32_t i = n - 1; i >= 0; i--)
+        {
+            int32_t v = sa[i];
+            if (v >= 1 && isS[v - 1])
+                sa[--bucket[s[v - 1] + 1]] = v - 1;
+        }
+    };
+
+    // Leftmost S-type positions
+    std::vector<int32_t> lmsIndex(n + 1, -1);
+    std::vector<int32_t> lms;
+    for (int32_t i = 1; i < n; i++)
+    {
+        if (!isS[i - 1] && isS[i])
+        {
+            lmsIndex[i] = static_cast<int32_t>(lms.size());
+            lms.push_back(i);
+        }
+    }
+    const int32_t m = static_cast<int32_t>(lms.size());
+
+    induce(lms);
+    if (!m)
+        return sa;
+
+    // Name the sorted LMS substrings and sort them recursively if names repeat
+    std::vector<int32_t> sortedLms;
+    sortedLms.reserve(m);
+    for (int32_t v : sa)
+    {
+        if (lmsIndex[v] != -1)
+            sortedLms.push_back(v);
+    }
+
+    std::vector<int32_t> reduced(m);
+    int32_t names = 0;
+    reduced[lmsIndex[sortedLms[0]]] = 0;
+    for (int32_t i = 1; i < m; i++)
+    {
+        int32_t l = sortedLms[i - 1], r = sortedLms[i];
+        int32_t endL = lmsIndex[l] + 1 < m ? lms[lmsIndex[l] + 1] : n;
+        int32_t endR = lmsIndex[r] + 1 < m ? lms[lmsIndex[r] + 1] : n;
+        bool same = endL - l == endR - r;
+        if (same)
+        {
+            while (l < endL && s[l] == s[r])
+            {
+                l++;
+                r++;
+            }
+            if (l == n || s[l] != s[r])
+                same = false;
+        }
+        if (!same)
+            names++;
+        reduced[lmsIndex[sortedLms[i]]] = names;
+    }
+
+    std::vector<int32_t> reducedSa = BuildSuffixArray(reduced.data(), m, names);
+    for (int32_t i = 0; i < m; i++)
+        sortedLms[i] = lms[reducedSa[i]];
+    induce(sortedLms);
+    return sa;
+}
+
+// Suffix array over a snapshot of a module's code ranges. Counts where a
+// wildcard signature matches with a few binary searches instead of a scan.
+class SuffixIndex
+{
+public:
+    // `read` fills a buffer from the module; ranges must be sorted
+    template<typename ReadFn>
+    void Build(const std::vector<ScanRange>& codeRanges, ReadFn&& read)
+    {
+        ranges = codeRanges;
+        offsets.clear();
+        size_t total = 0;
+        for (const auto& range : ranges)
+        {
+            offsets.push_back(total);
+            total += range.size;
+        }
+
+        text.resize(total);
+        for (size_t i = 0; i < ranges.size(); i++)
+            read(ranges[i].start, text.data() + offsets[i], ranges[i].size);
+
+        sa = BuildSuffixArray(text.data(), static_cast<int32_t>(text.size()), 255);
+    }
+
+    size_t Size() const { return text.size(); }
+    const uint8_t* Text() const { return text.data(); }
+
+    // Position of an address in the snapshot, SIZE_MAX outside the code ranges
+    size_t TextOffset(uintptr_t address) const
+    {
+        for (size_t i = 0; i < ranges.size(); i++)
+        {
+            if (address >= ranges[i].start && address - ranges[i].start < ranges[i].size)
+                return offsets[i] + (address - ranges[i].start);
+        }
+        return SIZE_MAX;
+    }
+
+    // Bytes from `offset` to the end of its code range
+    size_t RangeRemaining(size_t offset) const
+    {
+        size_t range = std::upper_bound(offsets.begin(), offsets.end(), offset) - offsets.begin() - 1;
+        return offsets[range] + ranges[range].size - offset;
+    }
+
+    // Number of matches of `pattern`, counting no further than `limit`.
+    // Matches spanning two code ranges are not counted, as a scan would not find them.
+    size_t Count(const SignatureView& pattern, size_t limit) const
+    {
+        // Look up the fixed run with the fewest occurrences, then verify those
+        size_t bestFirst = 0, bestLast = 0, bestOffset = 0;
+        bool haveRun = false;
+        for (size_t start = 0; start < pattern.length;)
+        {
+            if (!pattern.mask[start])
+            {
+                start++;
+                continue;
+            }
+            size_t end = start;
+            while (end < pattern.length && pattern.mask[end])
+                end++;
+
+            auto [first, last] = Find(pattern.value + start, end - start);
+            if (!haveRun || last - first < bestLast - bestFirst)
+            {
+                bestFirst = first;
+                bestLast = last;
+                bestOffset = start;
+                haveRun = true;
+            }
+            start = end;
+        }
+        if (!haveRun)
+            return limit;
+
+        size_t count = 0;
+        for (size_t i = bestFirst; i < bestLast && count < limit; i++)
+        {
+            size_t at = static_cast<size_t>(sa[i]);
+            if (at < bestOffset)
+                continue;
+            at -= bestOffset;
+            if (RangeRemaining(at) >= pattern.length && pattern.MatchesAt(text.data() + at))
+                count++;
+        }
+        return count;
+    }
+
+private:
+    // Suffix array interval of the suffixes starting with bytes[0..length)
+    std::pair<size_t, size_t> Find(const uint8_t* bytes, size_t length) const
+    {
+        auto compare = [&](int32_t at)
+        {
+            size_t available = std::min(length, text.size() - static_cast<size_t>(at));
+            int c = memcmp(text.data() + at, bytes, available);
+            return c ? c : available < length ? -1 : 0;
+        };
+        auto first = std::partition_point(sa.begin(), sa.end(), [&](int32_t at) { return compare(at) < 0; });
+        auto last = std::partition_point(first, sa.end(), [&](int32_t at) { return compare(at) == 0; });
+        return { static_cast<size_t>(first - sa.begin()), static_cast<size_t>(last - sa.begin()) };
+    }
+
+    std::vector<ScanRange> ranges;
+    std::vector<size_t> offsets;
+    std::vector<uint8_t> text;
+    std::vector<int32_t> sa;
+};
+
+// Where the scanner gets module bytes from: a live process or a dump file
+class MemorySource
+{
+public:
+    virtual ~MemorySource() {}
+
+    // Copy `size` bytes at `address` into `out`. Returns false if any byte could not be read.
+    virtual bool Read(uintptr_t address, void* out, size_t size) = 0;
+
+    // Copy as much of [address, address + size) as can be read, starting at
+    // `address`. Returns the number of bytes copied; a short count means the
+    // byte after them is unreadable.
+    virtual size_t ReadPrefix(uintptr_t address, void* out, size_t size) { return Read(address, out, size) ? size : 0; }
+
+    // Read several ranges at once, each to out + (range.start - base).
+    // Returns false if any byte could not be read.
+    virtual bool ReadPieces(uintptr_t base, uint8_t* out, const std::vector<ScanRange>& pieces)
+    {
+        bool complete = true;
+        for (const auto& piece : pieces)
+            complete &= Read(piece.start, out + (piece.start - base), piece.size);
+        return complete;
+    }
+
+    // Committed, readable parts of [start, start + size), sorted and coalesced
+    virtual std::vector<ScanRange> ReadableRanges(uintptr_t start, size_t size) { return { { start, size } }; }
+
+    // Pointer to [address, address + size) when the bytes are already mapped
+    // into this process, so they can be scanned without copying.
+    virtual const uint8_t* View(uintptr_t /*address*/, size_t /*size*/) { return nullptr; }
+};
+
+// Forwards to another source and counts the traffic. Only installed while
+// telemetry is enabled, so normal scans pay nothing for it.
+class CountingMemorySource : public MemorySource
+{
+public:
+    explicit CountingMemorySource(std::shared_ptr<MemorySource> source) : inner(std::move(source)) {}
+
+    bool Read(uintptr_t address, void* out, size_t size) override
+    {
+        readCalls++;
+        bytesRead += size;
+        if (inner->Read(address, out, size))
+            return true;
+        failedReads++;
+        return false;
+    }
+
+    size_t ReadPrefix(uintptr_t address, void* out, size_t size) override
+    {
+        readCalls++;
+        size_t done = inner->ReadPrefix(address, out, size);
+        bytesRead += done;
+        if (done < size)
+            failedReads++;
+        return done;
+    }
+
+    bool ReadPieces(uintptr_t base, uint8_t* out, const std::vector<ScanRange>& pieces) override
+    {
+        readCalls++;
+        for (const auto& piece : pieces)
+            bytesRead += piece.size;
+        if (inner->ReadPieces(base, out, pieces))
+            return true;
+        failedReads++;
+        return false;
+    }
+
+    std::vector<ScanRange> ReadableRanges(uintptr_t start, size_t size) override
+    {
+        return inner->ReadableRanges(start, size);
+    }
+
+    const uint8_t* View(uintptr_t address, size_t size) override
+    {
+        const uint8_t* view = inner->View(address, size);
+        if (view)
+        {
+            viewCalls++;
+            bytesViewed += size;
+        }
+        return view;
+    }
+
+    std::shared_ptr<MemorySource> inner;
+    std::atomic<uint64_t> readCalls{ 0 };
+    std::atomic<uint64_t> bytesRead{ 0 };
+    std::atomic<uint64_t> failedReads{ 0 };
+    std::atomic<uint64_t> viewCalls{ 0 };
+    std::atomic<uint64_t> bytesViewed{ 0 };
+};
+
+// LRU page cache in front of a live process. Small reads (operand
+// resolution, pointer dereferences, cache validation) are served from 4KB
+// pages, and scans hand in the pages around their matches with Store, so
+// resolving a match does not go back to the process. Bulk scan reads pass
+// straight through.
+class PageCache : public MemorySource
+{
+public:
+    static constexpr size_t kPageSize = 0x1000;
+    static constexpr size_t kBypassSize = 0x10000;
+
+    explicit PageCache(std::shared_ptr<MemorySource> source, size_t capacityPages = 1024)
+        : inner(std::move(source)), capacity(std::max<size_t>(capacityPages, 1)) {}
+
+    bool Read(uintptr_t address, void* out, size_t size) override
+    {
+        return ReadPrefix(address, out, size) == size;
+    }
+
+    size_t ReadPrefix(uintptr_t address, void* out, size_t size) override
+    {
+        if (size >= kBypassSize)
+            return inner->ReadPrefix(address, out, size);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        uint8_t* dest = static_cast<uint8_t*>(out);
+        size_t done = 0;
+        while (done < size)
+        {
+            uintptr_t at = address + done;
+            uintptr_t pageAddress = at & ~static_cast<uintptr_t>(kPageSize - 1);
+            size_t offset = at - pageAddress;
+            size_t want = std::min(kPageSize - offset, size - done);
+
+            const Page& page = Fetch(pageAddress, offset + want);
+            size_t available = page.valid > offset ? std::min(want, page.valid - offset) : 0;
+            memcpy(dest + done, page.bytes + offset, available);
+            done += available;
+            if (available < want)
+                break;
+        }
+        return done;
+    }
+
+    bool ReadPieces(uintptr_t base, uint8_t* out, const std::vector<ScanRange>& pieces) override
+    {
+        return inner->ReadPieces(base, out, pieces);
+    }
+
+    std::vector<ScanRange> ReadableRanges(uintptr_t start, size_t size) override
+    {
+        return inner->ReadableRanges(start, size);
+    }
+
+    // Keep the pages of [address, address + size) that `data` covers from
+    // their first byte. A page cut off at the end is kept up to `size` and
+    // read in full if a later read needs more of it.
+    void Store(uintptr_t address, const uint8_t* data, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        uintptr_t pageAddress = (address + kPageSize - 1) & ~static_cast<uintptr_t>(kPageSize - 1);
+        for (; pageAddress < address + size; pageAddress += kPageSize)
+        {
+            size_t valid = std::min<size_t>(kPageSize, address + size - pageAddress);
+            auto it = index.find(pageAddress);
+            if (it != index.end() && (it->second->probed || it->second->valid >= valid))
+            {
+                pages.splice(pages.begin(), pages, it->second);
+                continue;
+            }
+
+            Page& page = Acquire(pageAddress);
+            memcpy(page.bytes, data + (pageAddress - address), valid);
+            page.valid = valid;
+            page.probed = false;
+            stored++;
+        }
+    }
+
+    // Forget every page, e.g. after the module was reloaded
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pages.clear();
+        index.clear();
+    }
+
+    std::shared_ptr<MemorySource> inner;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t stored = 0;
+    uint64_t evictions = 0;
+
+private:
+    struct Page
+    {
+        uintptr_t address = 0;
+        size_t valid = 0;       // readable bytes from the start of the page
+        bool probed = false;    // valid came from a read, not from Store
+        uint8_t bytes[kPageSize];
+    };
+
+    // Page at `pageAddress` with at least `needed` bytes, read on a miss.
+    // A probed page shorter than that is as much as the process has.
+    const Page& Fetch(uintptr_t pageAddress, size_t needed)
+    {
+        auto it = index.find(pageAddress);
+        if (it != index.end() && (it->second->valid >= needed || it->second->probed))
+        {
+            hits++;
+            pages.splice(pages.begin(), pages, it->second);
+            return *it->second;
+        }
+
+        misses++;
+        Page& page = Acquire(pageAddress);
+        page.valid = inner->ReadPrefix(pageAddress, page.bytes, kPageSize);
+        page.probed = true;
+        return page;
+    }
+
+    // Most recently used slot for a page, reusing the least recently used
+    // one once the cache is full
+    Page& Acquire(uintptr_t pageAddress)
+    {
+        auto it = index.find(pageAddress);
+        if (it != index.end())
+        {
+            pages.splice(pages.begin(), pages, it->second);
+            return *it->second;
+        }
+
+        if (pages.size() >= capacity)
+        {
+            index.erase(pages.back().address);
+            pages.splice(pages.begin(), pages, std::prev(pages.end()));
+            evictions++;
+        }
+        else
+        {
+            pages.emplace_front();
+        }
+
+        Page& page = pages.front();
+        page.address = pageAddress;
+        page.valid = 0;
+        index[pageAddress] = pages.begin();
+        return page;
+    }
+
+    size_t capacity;
+    std::list<Page> pages;
+    std::unordered_map<uintptr_t, std::list<Page>::iterator> index;
+    std::mutex mutex;
+};
+
+#ifdef _WIN32
+// Live Windows process read through ReadProcessMemory
+class WindowsProcessSource : public MemorySource
+{
+public:
+    explicit WindowsProcessSource(HANDLE process) : hProcess(process) {}
+
+    ~WindowsProcessSource()
+    {
+        if (hProcess)
+            CloseHandle(hProcess);
+    }
+
+    bool Read(uintptr_t address, void* out, size_t size) override
+    {
+        SIZE_T bytesRead = 0;
+        return ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(address), out, size, &bytesRead) && bytesRead == size;
+    }
+
+    size_t ReadPrefix(uintptr_t address, void* out, size_t size) override
+    {
+        SIZE_T bytesRead = 0;
+        if (ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(address), out, size, &bytesRead))
+            return bytesRead;
+
+        // ERROR_PARTIAL_COPY does not reliably report how much was copied,
+        // so continue page by page up to the first unreadable one
+        size_t done = bytesRead;
+        while (done < size)
+        {
+            uintptr_t at = address + done;
+            size_t step = std::min<size_t>(0x1000 - (at & 0xFFF), size - done);
+            if (!ReadProcessMemory(hProcess, reinterpret_cast<LPCVOID>(at), static_cast<uint8_t*>(out) + done, step, &bytesRead))
+                return done + bytesRead;
+            done += step;
+        }
+        return done;
+    }
+
+    // Walk the address space with VirtualQueryEx, keeping committed pages
+    // that are neither PAGE_NOACCESS nor guard pages
+    std::vector<ScanRange> ReadableRanges(uintptr_t start, size_t size) override
+    {
+        std::vector<ScanRange> ranges;
+        const uintptr_t end = start + size;
+        uintptr_t address = start;
+        MEMORY_BASIC_INFORMATION info;
+
+        while (address < end && VirtualQueryEx(hProcess, reinterpret_cast<LPCVOID>(address), &info, sizeof(info)) == sizeof(info))
+        {
+            uintptr_t regionStart = reinterpret_cast<uintptr_t>(info.BaseAddress);
+            uintptr_t regionEnd = regionStart + info.RegionSize;
+            if (regionEnd <= address)
+                break;
+
+            if (info.State == MEM_COMMIT && !(info.Protect & (PAGE_NOACCESS | PAGE_GUARD)))
+                AppendRange(ranges, std::max(regionStart, address), std::min(regionEnd, end));
+            address = regionEnd;
+        }
+        return ranges;
+    }
+
+    HANDLE hProcess;
+};
+#else
+// One line of /proc/<pid>/maps
+struct ProcessMapping
+{
+    uintptr_t start;
+    uintptr_t end;
+    std::string perms;
+    std::string path;
+};
+
+inline std::vector<ProcessMapping> ReadProcessMaps(DWORD pid)
+{
+    std::vector<ProcessMapping> mappings;
+    std::ifstream maps("/proc/" + std::to_string(pid) + "/maps");
+    std::string line;
+
+    while (std::getline(maps, line))
+    {
+        ProcessMapping mapping;
+        char perms[8] = {};
+        unsigned long start = 0, end = 0;
+        int pathStart = 0;
+        if (sscanf(line.c_str(), "%lx-%lx %7s %*s %*s %*s %n", &start, &end, perms, &pathStart) < 3)
+            continue;
+
+        mapping.start = start;
+        mapping.end = end;
+        mapping.perms = perms;
+        if (pathStart > 0 && pathStart < static_cast<int>(line.size()))
+            mapping.path = line.substr(pathStart);
+        mappings.push_back(mapping);
+    }
+    return mappings;
+}
+
+// File name part of a mapping path
+inline std::string MappingBaseName(const std::string& path)
+{
+    size_t slash = path.find_last_of('/');
+    return slash == std::string::npos ? path : path.substr(slash + 1);
+}
+
+// Live Linux process read through process_vm_readv
+class LinuxProcessSource : public MemorySource
+{
+public:
+    explicit LinuxProcessSource(DWORD pid) : pid(pid) {}
+
+    bool Read(uintptr_t address, void* out, size_t size) override
+    {
+        return ReadPrefix(address, out, size) == size;
+    }
+
+    // process_vm_readv stops at the first unreadable page and reports what it copied
+    size_t ReadPrefix(uintptr_t address, void* out, size_t size) override
+    {
+        size_t done = 0;
+        while (done < size)
+        {
+            iovec local = { static_cast<uint8_t*>(out) + done, size - done };
+            iovec remote = { reinterpret_cast<void*>(address + done), size - done };
+            ssize_t n = process_vm_readv(static_cast<pid_t>(pid), &local, 1, &remote, 1, 0);
+            if (n <= 0)
+                break;
+            done += static_cast<size_t>(n);
+        }
+        return done;
+    }
+
+    // All pieces go out in as few process_vm_readv calls as the iovec limit
+    // allows. If one stops early, the rest of that batch is read piece by piece.
+    bool ReadPieces(uintptr_t base, uint8_t* out, const std::vector<ScanRange>& pieces) override
+    {
+        const size_t maxIovecs = 1024; // IOV_MAX
+        std::vector<iovec> local, remote;
+        bool complete = true;
+
+        for (size_t first = 0; first < pieces.size(); first += maxIovecs)
+        {
+            const size_t count = std::min(maxIovecs, pieces.size() - first);
+            local.resize(count);
+            remote.resize(count);
+            size_t total = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                const ScanRange& piece = pieces[first + i];
+                local[i] = { out + (piece.start - base), piece.size };
+                remote[i] = { reinterpret_cast<void*>(piece.start), piece.size };
+                total += piece.size;
+            }
+
+            ssize_t n = process_vm_readv(static_cast<pid_t>(pid), local.data(), count, remote.data(), count, 0);
+            if (n == static_cast<ssize_t>(total))
+                continue;
+
+            size_t copied = n > 0 ? static_cast<size_t>(n) : 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                const ScanRange& piece = pieces[first + i];
+                if (copied >= piece.size)
+                {
+                    copied -= piece.size;
+                    continue;
+                }
+
+                size_t done = copied;
+                copied = 0;
+                done += ReadPrefix(piece.start + done, out + (piece.start - base) + done, piece.size - done);
+                complete &= done == piece.size;
+            }
+        }
+        return complete;
+    }
+
+    // Readable mappings from /proc/<pid>/maps
+    std::vector<ScanRange> ReadableRanges(uintptr_t start, size_t size) override
+    {
+        std::vector<ScanRange> ranges;
+        const uintptr_t end = start + size;
+        for (const auto& mapping : ReadProcessMaps(pid))
+        {
+            if (mapping.perms.empty() || mapping.perms[0] != 'r' || mapping.end <= start || mapping.start >= end)
+                continue;
+            AppendRange(ranges, std::max(mapping.start, start), std::min(mapping.end, end));
+        }
+        return ranges;
+    }
+
+    DWORD pid;
+};
+#endif
+
+// Read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+    MappedFile() {}
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile()
+    {
+#ifdef _WIN32
+        if (data)
+            UnmapViewOfFile(data);
+        if (mapping)
+            CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE)
+            CloseHandle(file);
+#else
+        if (data)
+            munmap(const_cast<uint8_t*>(data), size);
+#endif
+    }
+
+    bool Open(const std::string& path)
+    {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+            return false;
+        size = static_cast<size_t>(fileSize.QuadPart);
+
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+            return false;
+
+        data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        return data != nullptr;
+#else
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0)
+        {
+            close(fd);
+            return false;
+        }
+        size = static_cast<size_t>(st.st_size);
+
+        void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (view == MAP_FAILED)
+            return false;
+        data = static_cast<const uint8_t*>(view);
+        return true;
+#endif
+    }
+
+    // The whole file is about to be read; start readahead now
+    void Prefetch() const
+    {
+#ifndef _WIN32
+        if (data)
+            madvise(const_cast<uint8_t*>(data), size, MADV_WILLNEED);
+#endif
+    }
+
+    const uint8_t* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+};
+
+// Module dump on disk, memory-mapped and scanned without copying.
+// Handles raw memory images (as dumped from a running process) as well as
+// PE files in their on-disk layout, which are translated through the section table.
+class DumpFileSource : public MemorySource
+{
+public:
+    bool Open(const std::string& path)
+    {
+        if (!file.Open(path))
+            return false;
+
+        data = file.Data();
+        fileSize = file.Size();
+        file.Prefetch();
+
+        imageSize = fileSize;
+        PEHeaderInfo pe;
+        if (ParsePEHeaders(data, fileSize, pe))
+        {
+            base = static_cast<uintptr_t>(pe.imageBase);
+
+            // A memory image is at least SizeOfImage bytes; anything smaller is a file on disk
+            if (fileSize < pe.sizeOfImage)
+            {
+                imageSize = pe.sizeOfImage;
+                headerSize = std::min<size_t>(pe.sizeOfHeaders, fileSize);
+                fileSections = pe.sections;
+            }
+        }
+        return true;
+    }
+
+    bool Read(uintptr_t address, void* out, size_t size) override
+    {
+        if (address < base || address - base > imageSize || size > imageSize - (address - base))
+            return false;
+
+        size_t rva = address - base;
+        if (fileSections.empty())
+        {
+            memcpy(out, data + rva, size);
+            return true;
+        }
+
+        // On-disk layout: copy each piece from its section, zero-fill the gaps
+        uint8_t* dest = static_cast<uint8_t*>(out);
+        memset(dest, 0, size);
+        CopyRange(0, headerSize, 0, rva, size, dest);
+        for (const auto& section : fileSections)
+        {
+            size_t rawSize = std::min<size_t>(section.rawSize, section.virtualSize ? section.virtualSize : section.rawSize);
+            if (section.rawOffset < fileSize)
+                rawSize = std::min<size_t>(rawSize, fileSize - section.rawOffset);
+            else
+                rawSize = 0;
+            CopyRange(section.rva, rawSize, section.rawOffset, rva, size, dest);
+        }
+        return true;
+    }
+
+    // Reads running past the end of the image stop there
+    size_t ReadPrefix(uintptr_t address, void* out, size_t size) override
+    {
+        if (address < base || address - base >= imageSize)
+            return 0;
+        size = std::min(size, imageSize - (address - base));
+        return Read(address, out, size) ? size : 0;
+    }
+
+    const uint8_t* View(uintptr_t address, size_t size) override
+    {
+        if (address < base || address - base > imageSize || size > imageSize - (address - base))
+            return nullptr;
+
+        size_t rva = address - base;
+        if (fileSections.empty())
+            return data + rva;
+
+        if (rva + size <= headerSize)
+            return data + rva;
+
+        for (const auto& section : fileSections)
+        {
+            if (rva >= section.rva && rva + size <= static_cast<size_t>(section.rva) + section.rawSize &&
+                static_cast<size_t>(section.rawOffset) + section.rawSize <= fileSize)
+                return data + section.rawOffset + (rva - section.rva);
+        }
+        return nullptr;
+    }
+
+    uintptr_t Base() const { return base; }
+    size_t Size() const { return imageSize; }
+
+private:
+    // Copy the part of [rva, rva + size) that overlaps the piece mapped at pieceRva
+    void CopyRange(size_t pieceRva, size_t pieceSize, size_t fileOffset, size_t rva, size_t size, uint8_t* dest) const
+    {
+        size_t from = std::max(pieceRva, rva);
+        size_t to = std::min(pieceRva + pieceSize, rva + size);
+        if (from < to)
+            memcpy(dest + (from - rva), data + fileOffset + (from - pieceRva), to - from);
+    }
+
+    MappedFile file;
+    const uint8_t* data = nullptr;
+    size_t fileSize = 0;
+    uintptr_t base = 0;
+    size_t imageSize = 0;
+    size_t headerSize = 0;
+    std::vector<PESection> fileSections;
+};
+
+// How a signature hit is turned into the address of the global it loads
+enum class ResolveKind : uint8_t
+{
+    RipRelative = 1,    // site + instructionLength + rel32 at site + operandOffset
+    Absolute32 = 2,     // 32-bit address stored at site + operandOffset
+    MemoryOperand = 3,  // the memory operand of the instruction at site, found by decoding it
+    StringFunction = 4, // start of the function whose code refers to the string in the pattern
+};
+
+struct ResolveRule
+{
+    ResolveKind kind;
+    uint8_t operandOffset;
+    uint8_t instructionLength;
+};
+
+constexpr ResolveRule RipRelative(uint8_t operandOffset, uint8_t instructionLength)
+{
+    return { ResolveKind::RipRelative, operandOffset, instructionLength };
+}
+
+constexpr ResolveRule Absolute32(uint8_t operandOffset)
+{
+    return { ResolveKind::Absolute32, operandOffset, 0 };
+}
+
+constexpr ResolveRule MemoryOperand()
+{
+    return { ResolveKind::MemoryOperand, 0, 0 };
+}
+
+constexpr ResolveRule StringFunction()
+{
+    return { ResolveKind::StringFunction, 0, 0 };
+}
+
+// A target's signature together with its resolve rule
+struct TargetSignature
+{
+    SignatureView view;
+    ResolveRule rule;
+};
+
+// Rule for the address an instruction refers to: its RIP-relative or
+// absolute [disp32] memory operand, else its absolute imm32 when
+// `immediateIsAddress` (32-bit code, where `push offset` and `mov reg, offset`
+// load addresses as immediates). False if the instruction refers to no address.
+inline bool AddressRule(const DecodedInstruction& instruction, bool immediateIsAddress, ResolveRule& out)
+{
+    if (instruction.ripRelative)
+        out = RipRelative(instruction.dispOffset, instruction.length);
+    else if (instruction.absoluteAddress && instruction.dispSize == 4 && !instruction.segmentBase)
+        out = Absolute32(instruction.dispOffset);
+    else if (immediateIsAddress && instruction.immSize == 4 && !instruction.relativeBranch)
+        out = Absolute32(instruction.immOffset);
+    else
+        return false;
+    return true;
+}
+
+// Code architectures a scanner specializes for. Everything that depends on
+// the architecture of the scanned module follows from these traits.
+struct ArchX86
+{
+    using Pointer = uint32_t;
+    static constexpr bool kIs64 = false;
+    static constexpr uint16_t kMachine = 0x014C;    // IMAGE_FILE_MACHINE_I386
+    static constexpr const char* kName = "x86";
+};
+
+struct ArchX64
+{
+    using Pointer = uint64_t;
+    static constexpr bool kIs64 = true;
+    static constexpr uint16_t kMachine = 0x8664;    // IMAGE_FILE_MACHINE_AMD64
+    static constexpr const char* kName = "x64";
+};
+
+// Whether a signature can match and resolve in code of architecture Arch.
+// rip rules exist only in x64 code and abs rules only in x86 code. A ref
+// pattern's first instruction, decoded with wildcards read as zero, must
+// have an address operand in Arch, and a general-purpose mov must move a
+// pointer: 8B 0D is a 32-bit load in x64 code, and 48 8B 0D starts with
+// dec eax in x86 code. Patterns with wildcards among the instruction's
+// opcode bytes are kept, since the bytes do not settle it.
+template<typename Arch>
+bool SignatureFits(const TargetSignature& signature)
+{
+    switch (signature.rule.kind)
+    {
+    case ResolveKind::RipRelative:
+        return Arch::kIs64;
+    case ResolveKind::Absolute32:
+        return !Arch::kIs64;
+    case ResolveKind::StringFunction:
+        return true;
+    default:
+        break;
+    }
+
+    const SignatureView& view = signature.view;
+    uint8_t code[15] = {};
+    size_t known = 0;
+    for (size_t i = 0; i < view.size() && i < sizeof(code); i++)
+    {
+        code[i] = view.value[i] & view.mask[i];
+        if (known == i && view.mask[i] == 0xFF)
+            known++;
+    }
+
+    DecodedInstruction instruction;
+    if (!DecodeInstruction(code, sizeof(code), Arch::kIs64, instruction))
+        return false;
+    const size_t opcodeBytes = instruction.dispSize ? instruction.dispOffset
+                               : instruction.immSize ? instruction.immOffset : instruction.length;
+    if (known < opcodeBytes)
+        return true;
+
+    ResolveRule rule;
+    if (!AddressRule(instruction, !Arch::kIs64 && instruction.immSize == 4, rule))
+        return false;
+
+    const bool moveRegister = instruction.opcodeMap == 0 && (instruction.opcode == 0x89 || instruction.opcode == 0x8B ||
+                                                             instruction.opcode == 0xA1 || instruction.opcode == 0xA3);
+    return !moveRegister || instruction.operandSize == sizeof(typename Arch::Pointer);
+}
+
+// One reference from code: the instruction at `site` loads, stores or takes
+// the address of `target`. Both are RVAs.
+struct Xref
+{
+    uint32_t target;
+    uint32_t site;
+    ResolveRule rule;   // resolves `target` from the bytes at `site`
+};
+
+// Cross-references of a module's code, made by decoding every instruction
+// once. "What does the instruction at X refer to" and "what refers to Y"
+// are binary searches over two sorted views of the same list.
+class XrefIndex
+{
+public:
+    // Sweep `size` bytes of code at `rva` linearly. A byte that does not decode
+    // is skipped, so the sweep falls back into step after padding or data.
+    // Only references into the image are kept; `isAddressImmediate(rva)` says
+    // whether the imm32 at that RVA holds an address.
+    template<typename IsAddressImmediate>
+    void Add(const uint8_t* code, size_t size, uint32_t rva, bool x64, uint64_t imageBase, size_t imageSize,
+             IsAddressImmediate&& isAddressImmediate)
+    {
+        for (size_t at = 0; at < size;)
+        {
+            DecodedInstruction instruction;
+            if (!DecodeInstruction(code + at, size - at, x64, instruction))
+            {
+                at++;
+                continue;
+            }
+
+            const uint32_t site = static_cast<uint32_t>(rva + at);
+            ResolveRule rule;
+            if (AddressRule(instruction, false, rule))
+                Record(code + at, site, rule, imageBase, imageSize);
+            // mov [addr], offset refers to two addresses
+            if (!x64 && instruction.immSize == 4 && !instruction.relativeBranch && isAddressImmediate(site + instruction.immOffset))
+                Record(code + at, site, Absolute32(instruction.immOffset), imageBase, imageSize);
+            at += instruction.length;
+        }
+    }
+
+    // Sort the views once every range has been added. Stable, so the memory
+    // operand stays ahead of the immediate that Add records at the same site.
+    void Finish()
+    {
+        std::stable_sort(xrefs.begin(), xrefs.end(), [](const Xref& a, const Xref& b) { return a.site < b.site; });
+        byTarget.resize(xrefs.size());
+        for (uint32_t i = 0; i < byTarget.size(); i++)
+            byTarget[i] = i;
+        std::stable_sort(byTarget.begin(), byTarget.end(), [this](uint32_t a, uint32_t b) { return xrefs[a].target < xrefs[b].target; });
+    }
+
+    size_t Size() const { return xrefs.size(); }
+
+    // References made by the instruction at `site`, memory operand first
+    std::pair<const Xref*, const Xref*> From(uint32_t site) const
+    {
+        auto range = std::equal_range(xrefs.begin(), xrefs.end(), Xref{ 0, site, {} },
+                                      [](const Xref& a, const Xref& b) { return a.site < b.site; });
+        return { xrefs.data() + (range.first - xrefs.begin()), xrefs.data() + (range.second - xrefs.begin()) };
+    }
+
+    // Every reference to `target`, in address order
+    std::vector<Xref> To(uint32_t target) const
+    {
+        auto first = std::lower_bound(byTarget.begin(), byTarget.end(), target,
+                                      [this](uint32_t i, uint32_t value) { return xrefs[i].target < value; });
+        std::vector<Xref> result;
+        for (auto it = first; it != byTarget.end() && xrefs[*it].target == target; ++it)
+            result.push_back(xrefs[*it]);
+        return result;
+    }
+
+private:
+    void Record(const uint8_t* instruction, uint32_t site, const ResolveRule& rule, uint64_t imageBase, size_t imageSize)
+    {
+        int64_t target;
+        if (rule.kind == ResolveKind::RipRelative)
+        {
+            int32_t displacement;
+            memcpy(&displacement, instruction + rule.operandOffset, 4);
+            target = int64_t(site) + rule.instructionLength + displacement;
+        }
+        else
+        {
+            uint32_t absolute;
+            memcpy(&absolute, instruction + rule.operandOffset, 4);
+            target = int64_t(absolute) - int64_t(imageBase);
+        }
+        if (target >= 0 && uint64_t(target) < imageSize)
+            xrefs.push_back({ static_cast<uint32_t>(target), site, rule });
+    }
+
+    std::vector<Xref> xrefs;            // by site
+    std::vector<uint32_t> byTarget;     // indices into xrefs, by target
+};
+
+// Printable ASCII and UTF-16LE strings of a module's read-only data, sorted
+// by text so the locations of a string are a binary search away. Strings must
+// be NUL-terminated and at least kMinLength characters; UTF-16 ones 2-aligned.
+class StringTable
+{
+public:
+    static const size_t kMinLength = 4;
+
+    struct Entry
+    {
+        uint32_t rva;
+        uint32_t offset;    // text in the pool, as ASCII for both encodings
+        uint32_t length;    // characters
+        bool wide;
+    };
+
+    // Extract the strings of `size` bytes at `rva`. Every byte is classified
+    // once, 64 at a time, into a printable and a zero bitmap; strings are then
+    // runs of printable bits found a word at a time. Binary data is full of
+    // short printable runs, so only positions that start kMinLength set bits
+    // are visited.
+    void Add(const uint8_t* data, size_t size, uint32_t rva)
+    {
+        const size_t words = (size + 63) / 64;
+        std::vector<uint64_t> printable(words + 1), zero(words + 1), wide(words + 1);
+        Classify(data, size, printable.data(), zero.data());
+
+        auto test = [&](const std::vector<uint64_t>& bits, size_t i) { return i < size && ((bits[i >> 6] >> (i & 63)) & 1); };
+        auto nextSet = [&](const std::vector<uint64_t>& bits, size_t i, bool set)
+        {
+            while (i < size)
+            {
+                uint64_t word = (set ? bits[i >> 6] : ~bits[i >> 6]) >> (i & 63);
+                if (word)
+                    return std::min(size, i + LowestSetBit64(word));
+                i = (i | 63) + 1;
+            }
+            return size;
+        };
+
+        // Bit i of the result: bits i .. i + width - 1 are all set
+        auto longRuns = [&](const std::vector<uint64_t>& bits, size_t width)
+        {
+            std::vector<uint64_t> runs(bits);
+            for (size_t w = 0; w < words; w++)
+            {
+                for (size_t k = 1; k < width; k++)
+                    runs[w] &= (bits[w] >> k) | (bits[w + 1] << (64 - k));
+            }
+            return runs;
+        };
+
+        const std::vector<uint64_t> asciiStarts = longRuns(printable, kMinLength);
+        for (size_t start = nextSet(asciiStarts, 0, true); start < size; start = nextSet(asciiStarts, start, true))
+        {
+            size_t end = nextSet(printable, start, false);
+            if (end - start >= kMinLength && test(zero, end))
+                Record(data + start, end - start, 1, rva + static_cast<uint32_t>(start), false);
+            start = end;
+        }
+
+        // A UTF-16 character is a printable byte at an even address followed
+        // by a zero byte. Filling in the odd bit after each turns a string into
+        // one contiguous run of set bits.
+        const uint64_t even = (rva & 1) ? 0xAAAAAAAAAAAAAAAAull : 0x5555555555555555ull;
+        for (size_t w = 0; w < words; w++)
+        {
+            uint64_t chars = printable[w] & ((zero[w] >> 1) | (zero[w + 1] << 63)) & even;
+            wide[w] |= chars | (chars << 1);
+            wide[w + 1] |= chars >> 63;
+        }
+        const std::vector<uint64_t> wideStarts = longRuns(wide, kMinLength * 2);
+        for (size_t start = nextSet(wideStarts, 0, true); start < size; start = nextSet(wideStarts, start, true))
+        {
+            size_t end = nextSet(wide, start, false);
+            if ((end - start) / 2 >= kMinLength && test(zero, end) && test(zero, end + 1))
+                Record(data + start, (end - start) / 2, 2, rva + static_cast<uint32_t>(start), true);
+            start = end;
+        }
+    }
+
+    // Sort by text once every range has been added
+    void Finish()
+    {
+        std::sort(entries.begin(), entries.end(), [this](const Entry& a, const Entry& b)
+        {
+            int order = pool.compare(a.offset, a.length, pool, b.offset, b.length);
+            return order < 0 || (order == 0 && a.rva < b.rva);
+        });
+    }
+
+    size_t Size() const { return entries.size(); }
+    std::string Text(const Entry& entry) const { return pool.substr(entry.offset, entry.length); }
+
+    // Every location of exactly `text`, in either encoding, in address order
+    std::vector<Entry> Find(const std::string& text) const
+    {
+        auto first = std::lower_bound(entries.begin(), entries.end(), text,
+                                      [this](const Entry& e, const std::string& value) { return pool.compare(e.offset, e.length, value) < 0; });
+        std::vector<Entry> found;
+        for (auto it = first; it != entries.end() && pool.compare(it->offset, it->length, text) == 0; ++it)
+            found.push_back(*it);
+        return found;
+    }
+
+private:
+    // Bit i of printable/zero: byte i is printable ASCII (or tab/CR/LF) / is 0
+    static void Classify(const uint8_t* data, size_t size, uint64_t* printable, uint64_t* zero)
+    {
+        size_t i = 0;
+#ifdef GMOD_HAVE_SIMD
+        const __m128i low = _mm_set1_epi8(0x1F), high = _mm_set1_epi8(0x7F), none = _mm_setzero_si128();
+        const __m128i tab = _mm_set1_epi8('\t'), lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+        for (; i + 64 <= size; i += 64)
+        {
+            uint64_t p = 0, z = 0;
+            for (int part = 0; part < 4; part++)
+            {
+                // Bytes >= 0x80 are negative as signed chars and fail the > 0x1F test
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + part * 16));
+                __m128i text = _mm_and_si128(_mm_cmpgt_epi8(b, low), _mm_cmplt_epi8(b, high));
+                text = _mm_or_si128(text, _mm_or_si128(_mm_cmpeq_epi8(b, tab), _mm_or_si128(_mm_cmpeq_epi8(b, lf), _mm_cmpeq_epi8(b, cr))));
+                p |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(text))) << (part * 16);
+                z |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(b, none)))) << (part * 16);
+            }
+            printable[i / 64] = p;
+            zero[i / 64] = z;
+        }
+#endif
+        for (; i < size; i++)
+        {
+            uint8_t b = data[i];
+            if ((b >= 0x20 && b < 0x7F) || b == '\t' || b == '\n' || b == '\r')
+                printable[i / 64] |= uint64_t(1) << (i & 63);
+            if (!b)
+                zero[i / 64] |= uint64_t(1) << (i & 63);
+        }
+    }
+
+    void Record(const uint8_t* text, size_t length, size_t stride, uint32_t rva, bool wide)
+    {
+        entries.push_back({ rva, static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(length), wide });
+        if (stride == 1)
+        {
+            pool.append(reinterpret_cast<const char*>(text), length);
+            return;
+        }
+        for (size_t i = 0; i < length; i++)
+            pool.push_back(static_cast<char>(text[i * stride]));
+    }
+
+    std::string pool;
+    std::vector<Entry> entries;
+};
+
+// Compiled signature database (.sigdb). Every record is fixed-size and
+// 4-byte aligned so a mapped file is used in place; loading only checks that
+// all offsets stay inside the file. Little-endian, like the modules it scans.
+//
+//   SigDbHeader | SigDbTarget[targetCount] | SigDbPattern[patternCount] | blob
+//
+// The blob holds the NUL-terminated target names, module hints and pattern
+// strings and the value/mask bytes of every pattern. Offsets into it are
+// blob-relative.
+static const char kSigDbMagic[8] = { 'G', 'M', 'O', 'D', 'S', 'I', 'G', '\0' };
+static const uint32_t kSigDbVersion = 2;
+
+struct SigDbHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t targetCount;
+    uint32_t patternCount;
+    uint32_t targetsOffset;
+    uint32_t patternsOffset;
+    uint32_t blobOffset;
+    uint32_t blobSize;
+};
+
+struct SigDbTarget
+{
+    uint32_t nameOffset;
+    uint32_t firstPattern;
+    uint32_t patternCount;
+    uint32_t modulesOffset;     // space-separated module name parts, "" if any module
+};
+
+struct SigDbPattern
+{
+    uint32_t textOffset;
+    uint32_t valueOffset;
+    uint32_t maskOffset;
+    uint32_t length;
+    uint32_t anchor1;
+    uint32_t anchor2;
+    uint8_t hasAnchor;
+    uint8_t resolveKind;
+    uint8_t operandOffset;
+    uint8_t instructionLength;
+};
+
+static_assert(sizeof(SigDbHeader) == 36 && sizeof(SigDbTarget) == 16 && sizeof(SigDbPattern) == 28,
+              "signature database records must stay packed");
+
+// Targets and their signatures, read straight out of a compiled image.
+// The image is either a mapped .sigdb file or one built in memory.
+class SignatureDatabase
+{
+public:
+    SignatureDatabase() {}
+    SignatureDatabase(const SignatureDatabase&) = delete;
+    SignatureDatabase& operator=(const SignatureDatabase&) = delete;
+
+    // Map a compiled .sigdb file
+    bool Load(const std::string& path, std::string& error)
+    {
+        if (!mapped.Open(path))
+        {
+            error = "cannot open " + path;
+            return false;
+        }
+        return Attach(mapped.Data(), mapped.Size(), error);
+    }
+
+    // Take over an image made by SignatureDatabaseBuilder
+    bool Adopt(std::vector<uint8_t> image, std::string& error)
+    {
+        owned = std::move(image);
+        return Attach(owned.data(), owned.size(), error);
+    }
+
+    size_t TargetCount() const { return header ? header->targetCount : 0; }
+    size_t TotalPatterns() const { return header ? header->patternCount : 0; }
+    const char* TargetName(size_t target) const { return String(targets[target].nameOffset); }
+    const char* TargetModules(size_t target) const { return String(targets[target].modulesOffset); }
+    size_t PatternCount(size_t target) const { return targets[target].patternCount; }
+
+    TargetSignature Pattern(size_t target, size_t index) const
+    {
+        const SigDbPattern& record = patterns[targets[target].firstPattern + index];
+        TargetSignature signature;
+        signature.view = { blob + record.valueOffset, blob + record.maskOffset, record.length,
+                           record.anchor1, record.anchor2, record.hasAnchor != 0, String(record.textOffset) };
+        signature.rule = { static_cast<ResolveKind>(record.resolveKind), record.operandOffset, record.instructionLength };
+        return signature;
+    }
+
+    // Index of a target by name, SIZE_MAX if the database has none
+    size_t FindTarget(const std::string& name) const
+    {
+        for (size_t target = 0; target < TargetCount(); target++)
+        {
+            if (name == TargetName(target))
+                return target;
+        }
+        return SIZE_MAX;
+    }
+
+    const uint8_t* Image() const { return data; }
+    size_t ImageSize() const { return size; }
+
+private:
+    const char* String(uint32_t offset) const { return reinterpret_cast<const char*>(blob + offset); }
+
+    // Bounds-check the image once so lookups can trust every offset
+    bool Attach(const uint8_t* image, size_t imageSize, std::string& error)
+    {
+        header = nullptr;
+        error = "corrupt signature database";
+        if (imageSize < sizeof(SigDbHeader) || reinterpret_cast<uintptr_t>(image) % 4)
+            return false;
+
+        const SigDbHeader* h = reinterpret_cast<const SigDbHeader*>(image);
+        if (memcmp(h->magic, kSigDbMagic, sizeof(kSigDbMagic)) != 0)
+        {
+            error = "not a signature database";
+            return false;
+        }
+        if (h->version != kSigDbVersion)
+        {
+            error = "unsupported signature database version " + std::to_string(h->version);
+            return false;
+        }
+
+        auto fits = [&](uint64_t offset, uint64_t bytes) { return offset % 4 == 0 && offset + bytes <= imageSize; };
+        if (!fits(h->targetsOffset, uint64_t(h->targetCount) * sizeof(SigDbTarget)) ||
+            !fits(h->patternsOffset, uint64_t(h->patternCount) * sizeof(SigDbPattern)) ||
+            !fits(h->blobOffset, h->blobSize) || h->blobSize == 0 || image[h->blobOffset + h->blobSize - 1] != 0)
+            return false;
+
+        const SigDbTarget* t = reinterpret_cast<const SigDbTarget*>(image + h->targetsOffset);
+        const SigDbPattern* p = reinterpret_cast<const SigDbPattern*>(image + h->patternsOffset);
+        for (uint32_t i = 0; i < h->targetCount; i++)
+        {
+            if (t[i].nameOffset >= h->blobSize || t[i].modulesOffset >= h->blobSize ||
+                uint64_t(t[i].firstPattern) + t[i].patternCount > h->patternCount)
+                return false;
+        }
+        for (uint32_t i = 0; i < h->patternCount; i++)
+        {
+            const SigDbPattern& r = p[i];
+            bool ruleOk = r.resolveKind == uint8_t(ResolveKind::MemoryOperand) || r.resolveKind == uint8_t(ResolveKind::StringFunction) ||
+                          ((r.resolveKind == uint8_t(ResolveKind::RipRelative) || r.resolveKind == uint8_t(ResolveKind::Absolute32)) &&
+                           r.operandOffset + 4u <= r.length);
+            if (r.textOffset >= h->blobSize || uint64_t(r.valueOffset) + r.length > h->blobSize ||
+                uint64_t(r.maskOffset) + r.length > h->blobSize || r.length == 0 || !r.hasAnchor ||
+                r.anchor1 >= r.length || r.anchor2 >= r.length || !ruleOk)
+                return false;
+        }
+
+        data = image;
+        size = imageSize;
+        header = h;
+        targets = t;
+        patterns = p;
+        blob = image + h->blobOffset;
+        error.clear();
+        return true;
+    }
+
+    MappedFile mapped;
+    std::vector<uint8_t> owned;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    const SigDbHeader* header = nullptr;
+    const SigDbTarget* targets = nullptr;
+    const SigDbPattern* patterns = nullptr;
+    const uint8_t* blob = nullptr;
+};
+
+// Lays out a signature database image from targets added in priority order
+class SignatureDatabaseBuilder
+{
+public:
+    // `modules`: space-separated parts of the names of the modules the target is in
+    void AddTarget(const std::string& name, const std::string& modules = "")
+    {
+        targets.push_back({ name, modules, {} });
+    }
+
+    // Add a signature to the last target
+    void AddPattern(const SignatureView& view, ResolveRule rule)
+    {
+        Entry entry;
+        entry.text = view.text;
+        entry.value.assign(view.value, view.value + view.length);
+        entry.mask.assign(view.mask, view.mask + view.length);
+        entry.anchor1 = static_cast<uint32_t>(view.anchor1);
+        entry.anchor2 = static_cast<uint32_t>(view.anchor2);
+        entry.hasAnchor = view.hasAnchor;
+        entry.rule = rule;
+        targets.back().entries.push_back(std::move(entry));
+    }
+
+    bool HasTarget() const { return !targets.empty(); }
+
+    std::vector<uint8_t> Build() const
+    {
+        std::vector<SigDbTarget> targetRecords;
+        std::vector<SigDbPattern> patternRecords;
+        std::vector<uint8_t> blob;
+
+        auto append = [&](const void* bytes, size_t count)
+        {
+            uint32_t offset = static_cast<uint32_t>(blob.size());
+            blob.insert(blob.end(), static_cast<const uint8_t*>(bytes), static_cast<const uint8_t*>(bytes) + count);
+            return offset;
+        };
+
+        for (const auto& target : targets)
+        {
+            SigDbTarget record;
+            record.nameOffset = append(target.name.c_str(), target.name.size() + 1);
+            record.firstPattern = static_cast<uint32_t>(patternRecords.size());
+            record.patternCount = static_cast<uint32_t>(target.entries.size());
+            record.modulesOffset = append(target.modules.c_str(), target.modules.size() + 1);
+            targetRecords.push_back(record);
+
+            for (const auto& entry : target.entries)
+            {
+                SigDbPattern pattern;
+                pattern.textOffset = append(entry.text.c_str(), entry.text.size() + 1);
+                pattern.valueOffset = append(entry.value.data(), entry.value.size());
+                pattern.maskOffset = append(entry.mask.data(), entry.mask.size());
+                pattern.length = static_cast<uint32_t>(entry.value.size());
+                pattern.anchor1 = entry.anchor1;
+                pattern.anchor2 = entry.anchor2;
+                pattern.hasAnchor = entry.hasAnchor ? 1 : 0;
+                pattern.resolveKind = static_cast<uint8_t>(entry.rule.kind);
+                pattern.operandOffset = entry.rule.operandOffset;
+                pattern.instructionLength = entry.rule.instructionLength;
+                patternRecords.push_back(pattern);
+            }
+        }
+        blob.push_back(0);
+
+        SigDbHeader header;
+        memcpy(header.magic, kSigDbMagic, sizeof(kSigDbMagic));
+        header.version = kSigDbVersion;
+        header.targetCount = static_cast<uint32_t>(targetRecords.size());
+        header.patternCount = static_cast<uint32_t>(patternRecords.size());
+        header.targetsOffset = sizeof(SigDbHeader);
+        header.patternsOffset = header.targetsOffset + header.targetCount * sizeof(SigDbTarget);
+        header.blobOffset = header.patternsOffset + header.patternCount * sizeof(SigDbPattern);
+        header.blobSize = static_cast<uint32_t>(blob.size());
+
+        std::vector<uint8_t> image(header.blobOffset + blob.size());
+        memcpy(image.data(), &header, sizeof(header));
+        if (!targetRecords.empty())
+            memcpy(image.data() + header.targetsOffset, targetRecords.data(), targetRecords.size() * sizeof(SigDbTarget));
+        if (!patternRecords.empty())
+            memcpy(image.data() + header.patternsOffset, patternRecords.data(), patternRecords.size() * sizeof(SigDbPattern));
+        memcpy(image.data() + header.blobOffset, blob.data(), blob.size());
+        return image;
+    }
+
+private:
+    struct Entry
+    {
+        std::string text;
+        std::vector<uint8_t> value;
+        std::vector<uint8_t> mask;
+        uint32_t anchor1 = 0;
+        uint32_t anchor2 = 0;
+        bool hasAnchor = false;
+        ResolveRule rule = {};
+    };
+
+    struct Target
+    {
+        std::string name;
+        std::string modules;
+        std::vector<Entry> entries;
+    };
+
+    std::vector<Target> targets;
+};
+
+// Strict IDA-style pattern parser for database sources: whitespace separated
+// hex bytes or '?'/'??' wildcards. Returns false on anything else.
+inline bool ParsePatternText(const std::string& text, std::vector<int>& bytes)
+{
+    bytes.clear();
+    std::istringstream tokens(text);
+    std::string token;
+    while (tokens >> token)
+    {
+        if (token == "?" || token == "??")
+        {
+            bytes.push_back(-1);
+            continue;
+        }
+        if (token.size() > 2 || HexDigit(token[0]) < 0 || (token.size() == 2 && HexDigit(token[1]) < 0))
+            return false;
+        bytes.push_back(token.size() == 2 ? HexDigit(token[0]) * 16 + HexDigit(token[1]) : HexDigit(token[0]));
+    }
+    return std::any_of(bytes.begin(), bytes.end(), [](int b) { return b != -1; });
+}
+
+// Compile signature database source text (.sig):
+//
+//   # comment, also allowed after a pattern
+//   [Target] <module>...             start a target; patterns follow in priority order.
+//                                    --all-modules looks for it only in modules whose
+//                                    name contains one of the words (all if omitted)
+//   ref <pattern>                    global = memory operand of the first instruction, decoded
+//   rip <disp> <length> <pattern>    global = site + length + rel32 at site + disp (x64)
+//   abs <disp> <pattern>             global = 32-bit address at site + disp (x86)
+//   func "<string>"                  start of the function whose code refers to the string
+//                                    (ASCII or UTF-16 in read-only data); no byte pattern
+//
+// Reports the first error with its line number.
+inline bool CompileSignatureSource(std::istream& in, std::vector<uint8_t>& image, std::string& error)
+{
+    SignatureDatabaseBuilder builder;
+    std::string line;
+    for (int number = 1; std::getline(in, line); number++)
+    {
+        auto fail = [&](const std::string& message)
+        {
+            error = "line " + std::to_string(number) + ": " + message;
+            return false;
+        };
+
+        // '#' starts a comment except inside a quoted string
+        bool quoted = false;
+        for (size_t i = 0; i < line.size(); i++)
+        {
+            if (line[i] == '"')
+                quoted = !quoted;
+            else if (line[i] == '#' && !quoted)
+                line.resize(i);
+        }
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+            continue;
+        line = line.substr(first, line.find_last_not_of(" \t\r") + 1 - first);
+
+        if (line[0] == '[')
+        {
+            // Target names end up as identifiers in the generated header.
+            // Words after the bracket name the modules the target is in.
+            const size_t close = line.find(']');
+            std::string name = line.substr(1, close == std::string::npos ? std::string::npos : close - 1);
+            bool identifier = close != std::string::npos && !name.empty() && !isdigit(static_cast<unsigned char>(name[0])) &&
+                              std::all_of(name.begin(), name.end(), [](char c) { return isalnum(static_cast<unsigned char>(c)) || c == '_'; });
+            if (!identifier)
+                return fail("bad target header, expected [Name] with a C identifier");
+
+            std::istringstream words(line.substr(close + 1));
+            std::string modules, word;
+            while (words >> word)
+                modules += (modules.empty() ? "" : " ") + word;
+            builder.AddTarget(name, modules);
+            continue;
+        }
+
+        if (!builder.HasTarget())
+            return fail("pattern before the first [Target]");
+
+        std::istringstream fields(line);
+        std::string kind;
+        unsigned disp = 0, length = 0;
+        fields >> kind;
+        if (kind == "func")
+        {
+            // func "<string>": the string's bytes stand in for the pattern
+            std::string rest;
+            std::getline(fields, rest);
+            size_t open = rest.find('"'), close = rest.rfind('"');
+            if (open == std::string::npos || close == open || rest.find_first_not_of(" \t", close + 1) != std::string::npos)
+                return fail("expected func \"<string>\"");
+            std::string text = rest.substr(open + 1, close - open - 1);
+            bool printable = std::all_of(text.begin(), text.end(), [](char c) { return c >= 0x20 && c < 0x7F && c != '"'; });
+            if (text.size() < StringTable::kMinLength || !printable)
+                return fail("string must be at least " + std::to_string(StringTable::kMinLength) + " printable ASCII characters, without quotes");
+
+            std::vector<int> bytes(text.begin(), text.end());
+            RuntimeSignature signature("func \"" + text + "\"", bytes);
+            builder.AddPattern(signature.View(), StringFunction());
+            continue;
+        }
+        if (kind != "ref")
+            fields >> disp;
+        if (kind == "rip")
+            fields >> length;
+        else if (kind != "abs" && kind != "ref")
+            return fail("unknown resolve rule '" + kind + "' (expected ref, rip, abs or func)");
+        if (fields.fail() || disp > 255 || length > 255)
+            return fail("bad operand offset or instruction length");
+
+        std::string text;
+        std::getline(fields, text);
+        text = text.substr(std::min(text.size(), text.find_first_not_of(" \t")));
+
+        std::vector<int> bytes;
+        if (!ParsePatternText(text, bytes))
+            return fail("bad pattern '" + text + "'");
+        if (kind != "ref" && disp + 4 > bytes.size())
+            return fail("operand runs past the end of the pattern");
+
+        RuntimeSignature signature(text, bytes);
+        builder.AddPattern(signature.View(), kind == "ref" ? MemoryOperand()
+                                             : kind == "rip" ? RipRelative(static_cast<uint8_t>(disp), static_cast<uint8_t>(length))
+                                                             : Absolute32(static_cast<uint8_t>(disp)));
+    }
+
+    image = builder.Build();
+    return true;
+}
+
+// Streams a memory range in fixed-size chunks through a small ring of
+// buffers. A background thread fills the next buffers while the caller
+// scans the current one. Consecutive chunks overlap by `overlap` bytes so
+// a match that crosses a chunk boundary is still fully contained in one chunk.
+class ChunkStream
+{
+public:
+    typedef std::function<bool(uintptr_t address, uint8_t* out, size_t size)> ReadFn;
+
+    struct Chunk
+    {
+        const uint8_t* data;
+        size_t size;        // bytes available, including the overlap
+        size_t ownedSize;   // bytes not repeated at the start of the next chunk
+        size_t offset;      // offset of the chunk from the stream base
+    };
+
+    ChunkStream(ReadFn readFn, uintptr_t base, size_t size, size_t chunkSize, size_t overlap, size_t bufferCount = 3)
+        : read(std::move(readFn)), base(base), totalSize(size), chunkSize(chunkSize), overlap(overlap),
+          chunkCount((size + chunkSize - 1) / chunkSize), slots(std::max<size_t>(bufferCount, 2))
+    {
+        for (auto& slot : slots)
+            slot.buffer.resize(chunkSize + overlap);
+
+        producer = std::thread([this] { Produce(); });
+    }
+
+    ~ChunkStream()
+    {
+        Cancel();
+        producer.join();
+    }
+
+    // Release the previous chunk and wait for the next one.
+    // Returns false once the whole range has been consumed.
+    bool Next(Chunk& chunk)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (consumed > 0)
+        {
+            slots[(consumed - 1) % slots.size()].ready = false;
+            changed.notify_all();
+        }
+
+        if (consumed >= chunkCount || cancelled)
+            return false;
+
+        Slot& slot = slots[consumed % slots.size()];
+        changed.wait(lock, [&] { return slot.ready || cancelled; });
+        if (cancelled)
+            return false;
+
+        size_t offset = consumed * chunkSize;
+        chunk.data = slot.buffer.data();
+        chunk.size = slot.size;
+        chunk.ownedSize = std::min(chunkSize, totalSize - offset);
+        chunk.offset = offset;
+        consumed++;
+        return true;
+    }
+
+    // Stop prefetching, e.g. once a match has been found
+    void Cancel()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+        changed.notify_all();
+    }
+
+private:
+    struct Slot
+    {
+        std::vector<uint8_t> buffer;
+        size_t size = 0;
+        bool ready = false;
+    };
+
+    void Produce()
+    {
+        for (size_t index = 0; index < chunkCount; index++)
+        {
+            Slot& slot = slots[index % slots.size()];
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&] { return !slot.ready || cancelled; });
+                if (cancelled)
+                    return;
+            }
+
+            // The slot is owned by this thread until it is marked ready
+            size_t offset = index * chunkSize;
+            size_t readSize = std::min(chunkSize + overlap, totalSize - offset);
+            if (!read(base + offset, slot.buffer.data(), readSize))
+                memset(slot.buffer.data(), 0, readSize);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            slot.size = readSize;
+            slot.ready = true;
+            changed.notify_all();
+        }
+    }
+
+    ReadFn read;
+    uintptr_t base;
+    size_t totalSize;
+    size_t chunkSize;
+    size_t overlap;
+    size_t chunkCount;
+    std::vector<Slot> slots;
+    size_t consumed = 0;
+    bool cancelled = false;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::thread producer;
+};
+
+// Fixed set of worker threads with one task deque per worker. Workers take
+// their own tasks from the front (lowest index first) and steal from the back
+// of other workers' deques once they run dry.
+class ThreadPool
+{
+public:
+    explicit ThreadPool(size_t threadCount)
+    {
+        threadCount = std::max<size_t>(threadCount, 1);
+        for (size_t i = 0; i < threadCount; i++)
+            queues.push_back(std::make_unique<Queue>());
+        for (size_t i = 0; i < threadCount; i++)
+            workers.emplace_back([this, i] { WorkerLoop(i); });
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& worker : workers)
+            worker.join();
+    }
+
+    size_t Size() const { return workers.size(); }
+
+    // Run fn(0) .. fn(count - 1) on the workers and wait for all of them.
+    // Indices are dealt round-robin so every worker starts at the low end.
+    void ParallelFor(size_t count, const std::function<void(size_t)>& fn)
+    {
+        if (!count)
+            return;
+
+        std::lock_guard<std::mutex> serial(runMutex);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            remaining = count;
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            Queue& queue = *queues[i % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.items.push_back(i);
+        }
+
+        std::unique_lock<std::mutex> lock(mutex);
+        generation++;
+        wake.notify_all();
+        done.wait(lock, [&] { return remaining == 0; });
+        job = nullptr;
+    }
+
+private:
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<size_t> items;
+    };
+
+    bool TakeOwn(size_t id, size_t& item)
+    {
+        Queue& queue = *queues[id];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.items.empty())
+            return false;
+        item = queue.items.front();
+        queue.items.pop_front();
+        return true;
+    }
+
+    bool Steal(size_t id, size_t& item)
+    {
+        for (size_t k = 1; k < queues.size(); k++)
+        {
+            Queue& queue = *queues[(id + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.items.empty())
+                continue;
+            item = queue.items.back();
+            queue.items.pop_back();
+            return true;
+        }
+        return false;
+    }
+
+    void WorkerLoop(size_t id)
+    {
+        size_t seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+            }
+
+            // Items are only queued while their job is installed, so the
+            // job read here always belongs to the item just taken
+            size_t item;
+            while (TakeOwn(id, item) || Steal(id, item))
+            {
+                const std::function<void(size_t)>* fn;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    fn = job;
+                }
+
+                (*fn)(item);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--remaining == 0)
+                    done.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::mutex runMutex;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    const std::function<void(size_t)>* job = nullptr;
+    size_t remaining = 0;
+    size_t generation = 0;
+    bool stopping = false;
+};
+
+// Reverse pointer index over a snapshot of readable memory: every aligned
+// pointer-sized value that points into one of the snapshot's regions, with
+// where it was found, sorted by value. "What points into [low, high]" is
+// then a binary search, first over a fence of every 64th value, which is
+// small enough to stay in cache, then inside one 64-entry block. The
+// snapshot itself is not kept: regions are streamed in 1MB chunks and only
+// the index stays, capped by a byte budget.
+template<typename Arch>
+class PointerMap
+{
+public:
+    using Pointer = typename Arch::Pointer;
+    static constexpr size_t kChunkSize = 0x100000;
+    static constexpr size_t kPageSize = 0x1000;
+    static constexpr size_t kBlock = 64;
+    static constexpr uint64_t kMaxAddress = static_cast<Pointer>(~static_cast<Pointer>(0));
+
+    struct Entry
+    {
+        Pointer value;
+        Pointer location;
+
+        bool operator<(const Entry& other) const
+        {
+            return value < other.value || (value == other.value && location < other.location);
+        }
+    };
+
+    // A found chain: [[root + offsets[0]] + offsets[1]] ... + offsets.back() is the target
+    using Chain = std::vector<uint32_t>;
+
+    // Index the readable `regions`, read through `read`, which behaves like
+    // MemorySource::ReadPrefix. Chunks are scanned on `pool` when given.
+    // Assembling the index briefly holds the chunks' entries as well, so at
+    // most budgetBytes / (2 * sizeof(Entry)) entries are kept. Returns false
+    // if the budget cut the index short. Regions are clipped to what a
+    // Pointer can address: a 32-bit process under WOW64 also has 64-bit
+    // mappings above 4GB, whose slots would alias low addresses.
+    bool Build(const std::vector<ScanRange>& regions, const std::function<size_t(uintptr_t, void*, size_t)>& read,
+               size_t budgetBytes, ThreadPool* pool)
+    {
+        ranges.clear();
+        for (const auto& range : regions)
+        {
+            if (!range.size || range.start > kMaxAddress)
+                continue;
+            const uint64_t last = std::min<uint64_t>(static_cast<uint64_t>(range.start) + (range.size - 1), kMaxAddress);
+            ranges.push_back({ range.start, static_cast<size_t>(last - range.start + 1) });
+        }
+        entries.clear();
+        fences.clear();
+        snapshotBytes = 0;
+
+        std::vector<ScanRange> chunks;
+        for (const auto& range : ranges)
+        {
+            snapshotBytes += range.size;
+            for (size_t offset = 0; offset < range.size; offset += kChunkSize)
+                chunks.push_back({ range.start + offset, std::min(kChunkSize, range.size - offset) });
+        }
+
+        const size_t maxEntries = budgetBytes / (2 * sizeof(Entry));
+        std::atomic<size_t> total(0);
+        std::atomic<bool> full(false);
+        std::vector<std::vector<Entry>> found(chunks.size());
+
+        auto scanChunk = [&](size_t index)
+        {
+            if (full)
+                return;
+            const ScanRange& chunk = chunks[index];
+            std::vector<uint8_t> buffer(chunk.size);
+            std::vector<Entry>& local = found[index];
+
+            // A short read stops at an unreadable page; skip that page and go on
+            for (size_t at = 0; at < chunk.size;)
+            {
+                const size_t done = read(chunk.start + at, buffer.data() + at, chunk.size - at);
+                const uintptr_t first = (chunk.start + at + sizeof(Pointer) - 1) & ~static_cast<uintptr_t>(sizeof(Pointer) - 1);
+                for (uintptr_t address = first; address + sizeof(Pointer) <= chunk.start + at + done; address += sizeof(Pointer))
+                {
+                    Pointer value;
+                    memcpy(&value, buffer.data() + (address - chunk.start), sizeof(value));
+                    if (Contains(value))
+                        local.push_back({ value, static_cast<Pointer>(address) });
+                }
+                at += done;
+                if (at < chunk.size)
+                    at = ((chunk.start + at) / kPageSize + 1) * kPageSize - chunk.start;
+            }
+
+            if (total.fetch_add(local.size()) + local.size() > maxEntries)
+            {
+                full = true;
+                std::vector<Entry>().swap(local);
+            }
+        };
+
+        if (pool)
+            pool->ParallelFor(chunks.size(), scanChunk);
+        else
+        {
+            for (size_t index = 0; index < chunks.size(); index++)
+                scanChunk(index);
+        }
+
+        size_t count = 0;
+        for (const auto& local : found)
+            count += local.size();
+        entries.reserve(count);
+        for (auto& local : found)
+        {
+            entries.insert(entries.end(), local.begin(), local.end());
+            std::vector<Entry>().swap(local);
+        }
+        std::sort(entries.begin(), entries.end());
+
+        for (size_t i = 0; i < entries.size(); i += kBlock)
+            fences.push_back(entries[i].value);
+        return !full;
+    }
+
+    size_t Size() const { return entries.size(); }
+    size_t Regions() const { return ranges.size(); }
+    size_t SnapshotBytes() const { return snapshotBytes; }
+    size_t MemoryBytes() const { return entries.capacity() * sizeof(Entry) + fences.capacity() * sizeof(Pointer); }
+
+    // Entries whose value lies in [low, high], in value order
+    std::pair<const Entry*, const Entry*> PointingInto(Pointer low, Pointer high) const
+    {
+        const Entry* data = entries.data();
+        auto byValue = [](const Entry& entry, Pointer value) { return entry.value < value; };
+        auto valueBefore = [](Pointer value, const Entry& entry) { return value < entry.value; };
+
+        // The first value >= low is in the block before the first fence >= low, or starts that block
+        size_t block = std::lower_bound(fences.begin(), fences.end(), low) - fences.begin();
+        const Entry* begin = std::lower_bound(data + (block ? block - 1 : 0) * kBlock,
+                                              data + std::min(block * kBlock, entries.size()), low, byValue);
+
+        // The last value <= high is in the block before the first fence > high
+        block = std::upper_bound(fences.begin(), fences.end(), high) - fences.begin();
+        const Entry* end = block ? std::upper_bound(data + (block - 1) * kBlock, data + std::min(block * kBlock, entries.size()),
+                                                    high, valueBefore)
+                                 : data;
+        return { begin, std::max(begin, end) };
+    }
+
+    // Chains of at most `depth` dereferences from the pointer-sized slots
+    // in [root, root + maxOffset] to `target`, every offset at most
+    // maxOffset. Searched backwards from the target one level at a time:
+    // each level's addresses are independent lookups, split across `pool`.
+    // A level keeps at most maxNodes addresses and the search stops after
+    // maxChains chains, so memory stays bounded; `truncated` tells whether
+    // either limit was hit. Shorter chains come first.
+    std::vector<Chain> FindChains(uintptr_t root, uintptr_t target, size_t depth, uint32_t maxOffset, size_t maxChains,
+                                  size_t maxNodes, ThreadPool* pool, bool& truncated) const
+    {
+        // Level k holds slots that reach an address of level k - 1 with one
+        // dereference plus `offset`; level 0 is the target itself
+        struct Node
+        {
+            Pointer address;
+            uint32_t parent;
+            uint32_t offset;
+        };
+        struct Hit
+        {
+            Pointer location;
+            uint32_t parent;
+            uint32_t offset;
+        };
+        const size_t kBatch = 256;
+
+        std::vector<std::vector<Node>> levels(1, { { static_cast<Pointer>(target), 0, 0 } });
+        std::vector<Chain> chains;
+        truncated = false;
+
+        for (size_t level = 1; level <= depth && !levels.back().empty() && chains.size() < maxChains; level++)
+        {
+            const std::vector<Node>& nodes = levels.back();
+            const size_t batches = (nodes.size() + kBatch - 1) / kBatch;
+            std::vector<std::vector<Node>> next(batches);
+            std::vector<std::vector<Hit>> hits(batches);
+
+            auto lookup = [&](size_t batch)
+            {
+                for (size_t n = batch * kBatch; n < std::min(nodes.size(), (batch + 1) * kBatch); n++)
+                {
+                    const Pointer address = nodes[n].address;
+                    const Pointer low = address > maxOffset ? static_cast<Pointer>(address - maxOffset) : 0;
+                    auto range = PointingInto(low, address);
+                    for (const Entry* entry = range.first; entry != range.second; entry++)
+                    {
+                        const uint32_t offset = static_cast<uint32_t>(address - entry->value);
+                        if (entry->location >= root && entry->location - root <= maxOffset)
+                            hits[batch].push_back({ entry->location, static_cast<uint32_t>(n), offset });
+                        else if (level < depth)
+                            next[batch].push_back({ entry->location, static_cast<uint32_t>(n), offset });
+                    }
+                }
+            };
+            if (pool)
+                pool->ParallelFor(batches, lookup);
+            else
+            {
+                for (size_t batch = 0; batch < batches; batch++)
+                    lookup(batch);
+            }
+
+            // Batches are joined in order, so results do not depend on scheduling
+            for (const auto& batch : hits)
+            {
+                for (const Hit& hit : batch)
+                {
+                    if (chains.size() >= maxChains)
+                    {
+                        truncated = true;
+                        break;
+                    }
+                    Chain chain = { static_cast<uint32_t>(hit.location - root), hit.offset };
+                    for (size_t up = level - 1, n = hit.parent; up > 0; n = levels[up][n].parent, up--)
+                        chain.push_back(levels[up][n].offset);
+                    chains.push_back(std::move(chain));
+                }
+            }
+
+            std::vector<Node> merged;
+            for (auto& batch : next)
+            {
+                const size_t room = maxNodes - std::min(maxNodes, merged.size());
+                truncated |= batch.size() > room;
+                merged.insert(merged.end(), batch.begin(), batch.begin() + std::min(room, batch.size()));
+                std::vector<Node>().swap(batch);
+            }
+            levels.push_back(std::move(merged));
+        }
+        return chains;
+    }
+
+private:
+    // Is `value` inside one of the snapshot's regions?
+    bool Contains(Pointer value) const
+    {
+        auto it = std::upper_bound(ranges.begin(), ranges.end(), static_cast<uintptr_t>(value),
+                                   [](uintptr_t address, const ScanRange& range) { return address < range.start; });
+        return it != ranges.begin() && value - (it - 1)->start < (it - 1)->size;
+    }
+
+    std::vector<ScanRange> ranges;
+    std::vector<Entry> entries;
+    std::vector<Pointer> fences;
+    size_t snapshotBytes = 0;
+};
+
+// Write a file through a temporary next to it that is then renamed over
+// it, so a reader never sees a half-written file. False if writing failed.
+inline bool WriteFileAtomically(const std::string& filename, const std::string& contents)
+{
+    const std::string temporary = filename + ".tmp";
+    {
+        std::ofstream file(temporary);
+        if (!file.is_open() || !(file << contents).flush())
+            return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, filename, error);
+    if (error)
+    {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+// Quote and escape a string for a JSON document
+inline std::string JsonString(const std::string& text)
+{
+    std::string out = "\"";
+    for (unsigned char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            out += '\\';
+            out += static_cast<char>(c);
+        }
+        else if (c < 0x20)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        }
+        else
+        {
+            out += static_cast<char>(c);
+        }
+    }
+    return out + "\"";
+}
+
+// Hot-path measurements collected while telemetry is enabled
+struct ScanTelemetry
+{
+    // One FindPattern call or signature pass
+    struct Operation
+    {
+        std::string kind;
+        std::string pattern;
+        size_t patterns = 0;
+        uint64_t bytesScanned = 0;
+        uint64_t candidates = 0;
+        uint64_t fullCompares = 0;
+        double ms = 0;
+        uintptr_t result = 0;
+    };
+
+    // One pattern tried by a ScanGMod* target scan
+    struct Attempt
+    {
+        std::string target;
+        std::string pattern;
+        std::string source;
+        uintptr_t site = 0;
+        bool accepted = false;
+        size_t rejected = 0;        // hits that resolved outside data before `site`
+        bool rescanned = false;     // finding the other hits took a find-all scan
+        double ms = 0;
+    };
+
+    std::shared_ptr<CountingMemorySource> reads;
+    std::vector<Operation> operations;
+    std::vector<Attempt> attempts;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+
+    // Matcher counters handed over by pool workers, see FlushThreadCounters
+    std::atomic<uint64_t> workerCandidates{ 0 };
+    std::atomic<uint64_t> workerCompares{ 0 };
+};
+
+class GModOffsetScanner
+{
+public:
+    std::shared_ptr<MemorySource> memory;
+    DWORD processId;
+    std::string processName;
+    std::string moduleName;
+    uintptr_t moduleBase;
+    size_t moduleSize;
+
+    // Built-in signatures, used when no GModSignatures.sigdb is present.
+    // Each resolves through the memory operand of its first instruction, which
+    // is absolute in x86 builds and RIP-relative in x64 ones.
+
+    // Source Engine entity list patterns
+    static inline const std::vector<TargetSignature> entityListPatterns = {
+        // Common Source Engine patterns
+        { GMOD_SIG("8B 0D ? ? ? ? 8B 01 FF 50 ? 85 C0"), MemoryOperand() },        // mov ecx,[addr]; mov eax,[ecx]
+        { GMOD_SIG("A1 ? ? ? ? 8B 14 B8 85 D2"), MemoryOperand() },                // mov eax,[addr]; mov edx,[eax+edi*4]
+        { GMOD_SIG("8B 15 ? ? ? ? 33 C9 83 FA FF"), MemoryOperand() },             // mov edx,[addr]
+        { GMOD_SIG("8B 0D ? ? ? ? 8B 14 81"), MemoryOperand() },                   // mov ecx,[addr]; mov edx,[ecx+eax*4]
+        // x64 patterns
+        { GMOD_SIG("48 8B 0D ? ? ? ? 48 85 C9 74 ? 48 8B 01"), MemoryOperand() }, // mov rcx,[addr]
+        { GMOD_SIG("4C 8B 05 ? ? ? ? 4D 85 C0"), MemoryOperand() },                // mov r8,[addr]
+    };
+
+    // Source Engine local player patterns
+    static inline const std::vector<TargetSignature> localPlayerPatterns = {
+        { GMOD_SIG("8B 0D ? ? ? ? 83 F9 FF 74 ? 8B 01"), MemoryOperand() },        // mov ecx,[addr]
+        { GMOD_SIG("A1 ? ? ? ? 83 F8 FF 74 ? 8B 08"), MemoryOperand() },           // mov eax,[addr]
+        { GMOD_SIG("8B 15 ? ? ? ? 85 D2 74 ? 8B 02"), MemoryOperand() },           // mov edx,[addr]
+        // x64 patterns
+        { GMOD_SIG("48 8B 0D ? ? ? ? 48 85 C9 74 ? E8"), MemoryOperand() },        // mov rcx,[addr]
+        { GMOD_SIG("48 8B 05 ? ? ? ? 48 85 C0 74 ? 48 8B 08"), MemoryOperand() }, // mov rax,[addr]
+    };
+
+    // Source Engine view matrix patterns
+    static inline const std::vector<TargetSignature> viewMatrixPatterns = {
+        { GMOD_SIG("F3 0F 10 05 ? ? ? ? F3 0F 11 45"), MemoryOperand() },          // movss xmm0,[addr]
+        { GMOD_SIG("0F 10 05 ? ? ? ? 0F 11 45"), MemoryOperand() },                // movups xmm0,[addr]
+        { GMOD_SIG("F3 0F 10 0D ? ? ? ? F3 0F 59 0D"), MemoryOperand() },          // movss xmm1,[addr]
+        // x64 patterns
+        { GMOD_SIG("0F 10 05 ? ? ? ? 8D 85 ? ? ? ? B9"), MemoryOperand() },        // movups xmm0,[addr]
+        { GMOD_SIG("F3 0F 10 05 ? ? ? ? F3 0F 11 85"), MemoryOperand() },          // movss xmm0,[addr]
+    };
+
+    // Database made from the built-in lists, shared by every scanner
+    static std::shared_ptr<const SignatureDatabase> BuiltinSignatures()
+    {
+        static const std::shared_ptr<const SignatureDatabase> database = []
+        {
+            SignatureDatabaseBuilder builder;
+            const struct
+            {
+                const char* name;
+                const char* modules;
+                const std::vector<TargetSignature>* patterns;
+            } lists[] = {
+                { "EntityList", "client", &entityListPatterns },
+                { "LocalPlayer", "client", &localPlayerPatterns },
+                { "ViewMatrix", "engine", &viewMatrixPatterns },
+            };
+            for (const auto& list : lists)
+            {
+                builder.AddTarget(list.name, list.modules);
+                for (const auto& signature : *list.patterns)
+                    builder.AddPattern(signature.view, signature.rule);
+            }
+
+            auto built = std::make_shared<SignatureDatabase>();
+            std::string error;
+            built->Adopt(builder.Build(), error);
+            return built;
+        }();
+        return database;
+    }
+
+    // Load a signature database: a compiled .sigdb is mapped as-is, anything
+    // else is compiled from source in memory. Returns null on error.
+    static std::shared_ptr<const SignatureDatabase> OpenSignatures(const std::string& path, std::string& error)
+    {
+        auto database = std::make_shared<SignatureDatabase>();
+        if (database->Load(path, error))
+            return database;
+        if (error != "not a signature database")
+            return nullptr;
+
+        std::ifstream source(path);
+        std::vector<uint8_t> image;
+        if (!source.is_open() || !CompileSignatureSource(source, image, error))
+            return nullptr;
+
+        database = std::make_shared<SignatureDatabase>();
+        if (!database->Adopt(std::move(image), error))
+            return nullptr;
+        return database;
+    }
+
+    // Outcome of a target scan: resolved global, matching instruction and winning pattern
+    struct TargetResult
+    {
+        uintptr_t address = 0;
+        uintptr_t site = 0;
+        std::string pattern;
+        size_t matches = 0;     // sites matching the winning pattern, 0 if not checked
+        size_t globals = 0;     // distinct data addresses those sites resolve to (functions, for func signatures)
+        size_t mismatches = 0;  // differing bytes when found by the approximate fallback
+    };
+    std::map<std::string, TargetResult> targetResults;
+
+    // Targets this scanner is responsible for; empty means every target of
+    // the database. ScanAllModules gives each module only the targets routed to it.
+    std::vector<std::string> targetFilter;
+
+    // Module each result was found in, when the results of several modules
+    // are merged into one report; empty for a single-module scan
+    struct LoadedModule
+    {
+        std::string name;
+        uintptr_t base = 0;
+        size_t size = 0;
+    };
+    std::map<std::string, LoadedModule> resultModules;
+
+    // First match of every signature, filled by RunSignaturePass
+    std::map<std::string, uintptr_t> signatureHits;
+
+    // Every match of every signature in signatureSet order, also from RunSignaturePass
+    MatchList signatureMatches;
+    bool signaturePassDone = false;
+
+    // Differing bytes a signature may have when no target signature matches
+    // exactly; 0 turns the approximate fallback off
+    size_t approximateMismatches = 0;
+
+    // Worker threads for module scans; 1 keeps the streaming single-thread path
+    size_t threadCount = std::max<unsigned>(std::thread::hardware_concurrency(), 1u);
+    std::shared_ptr<ThreadPool> pool;
+
+    // PE headers of the current module, parsed once in SetModule
+    PEHeaderInfo peInfo;
+    bool hasPEInfo = false;
+
+    // Bitness of the attached process, and the architecture of the current
+    // module's code: its PE Machine field, else the process bitness
+    bool process64 = sizeof(void*) == 8;
+    bool code64 = sizeof(void*) == 8;
+    std::vector<ScanRange> codeRanges;
+
+    // Committed, readable parts of the module; scans read only these
+    std::vector<ScanRange> readableRanges;
+
+    // Code snapshot and relocations for signature generation, built on demand
+    std::shared_ptr<SuffixIndex> suffixIndex;
+    std::vector<uint32_t> relocations;
+    bool relocationsLoaded = false;
+
+    // Cross-references of the module's code, built on demand
+    std::shared_ptr<XrefIndex> xrefIndex;
+
+    // Strings of the read-only data and the x64 function table, for func
+    // signatures, built on demand
+    struct RuntimeFunction
+    {
+        uint32_t begin;
+        uint32_t end;
+        uint32_t unwind;
+    };
+    std::shared_ptr<StringTable> stringTable;
+    std::vector<RuntimeFunction> functionTable;
+    bool functionTableLoaded = false;
+
+    // Page cache in front of a live process; null for dumps, which are mapped
+    std::shared_ptr<PageCache> pageCache;
+
+    // Counters and timers, null unless EnableTelemetry was called
+    std::shared_ptr<ScanTelemetry> telemetry;
+
+    // Progress messages; batch mode points this at a null stream
+    std::ostream* console = &std::cout;
+
+    // Targets and their signatures; the built-in set unless one was loaded
+    std::shared_ptr<const SignatureDatabase> signatureDb;
+
+    // Every distinct signature of the database that can match one
+    // architecture, compiled into one matcher. Immutable once built, so
+    // batch scans share a single instance per architecture.
+    struct SignatureSet
+    {
+        std::shared_ptr<const SignatureDatabase> database;
+        bool x64 = false;
+        size_t skipped = 0;     // signatures that cannot match this architecture
+        std::vector<SignatureView> patterns;
+        MultiPatternScanner matcher;
+    };
+    std::shared_ptr<const SignatureSet> signatureSet;
+
+    GModOffsetScanner() : processId(0), moduleBase(0), moduleSize(0) {}
+
+    // List all running processes
+    std::vector<std::pair<std::string, DWORD>> ListProcesses()
+    {
+        std::vector<std::pair<std::string, DWORD>> processes;
+#ifndef _WIN32
+        DIR* proc = opendir("/proc");
+        if (!proc)
+            return processes;
+
+        while (dirent* entry = readdir(proc))
+        {
+            char* end = nullptr;
+            unsigned long pid = strtoul(entry->d_name, &end, 10);
+            if (!pid || *end)
+                continue;
+
+            std::ifstream comm(std::string("/proc/") + entry->d_name + "/comm");
+            std::string name;
+            if (std::getline(comm, name))
+                processes.push_back({ name, static_cast<DWORD>(pid) });
+        }
+
+        closedir(proc);
+        std::sort(processes.begin(), processes.end(),
+                  [](const auto& a, const auto& b) { return a.second < b.second; });
+        return processes;
+#else
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+        if (snapshot == INVALID_HANDLE_VALUE)
+            return processes;
+
+        PROCESSENTRY32 entry;
+        entry.dwSize = sizeof(PROCESSENTRY32);
+
+        if (Process32First(snapshot, &entry))
+        {
+            do
+            {
+                processes.push_back({ entry.szExeFile, entry.th32ProcessID });
+            } while (Process32Next(snapshot, &entry));
+        }
+
+        CloseHandle(snapshot);
+        return processes;
+#endif
+    }
+
+    // List modules for a process
+    std::vector<std::string> ListModules(DWORD pid)
+    {
+        std::vector<std::string> modules;
+#ifndef _WIN32
+        // Every file-backed mapping, in load order
+        for (const auto& mapping : ReadProcessMaps(pid))
+        {
+            if (mapping.path.empty() || mapping.path[0] != '/')
+                continue;
+
+            std::string name = MappingBaseName(mapping.path);
+            if (std::find(modules.begin(), modules.end(), name) == modules.end())
+                modules.push_back(name);
+        }
+        return modules;
+#else
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, pid);
+        if (snapshot == INVALID_HANDLE_VALUE)
+            return modules;
+
+        MODULEENTRY32 entry;
+        entry.dwSize = sizeof(MODULEENTRY32);
+
+        if (Module32First(snapshot, &entry))
+        {
+            do
+            {
+                modules.push_back(entry.szModule);
+            } while (Module32Next(snapshot, &entry));
+        }
+
+        CloseHandle(snapshot);
+        return modules;
+#endif
+    }
+
+    // Attach to process by PID
+    bool AttachToProcess(DWORD pid)
+    {
+        processId = pid;
+#ifndef _WIN32
+        auto source = std::make_shared<LinuxProcessSource>(pid);
+        auto mappings = ReadProcessMaps(pid);
+        uint8_t probe;
+        if (mappings.empty() || !source->Read(mappings.front().start, &probe, 1))
+        {
+            *console << "[-] Failed to read process memory. Check ptrace permissions.\n";
+            return false;
+        }
+        pageCache = std::make_shared<PageCache>(source);
+        memory = pageCache;
+
+        std::ifstream comm("/proc/" + std::to_string(pid) + "/comm");
+        std::getline(comm, processName);
+
+        // ELF class of the executable: 2 is 64-bit
+        char ident[5] = {};
+        std::ifstream executable("/proc/" + std::to_string(pid) + "/exe", std::ios::binary);
+        process64 = executable.read(ident, sizeof(ident)) && memcmp(ident, "\x7F" "ELF", 4) == 0 ? ident[4] == 2
+                                                                                                 : sizeof(void*) == 8;
+#else
+        HANDLE hProcess = OpenProcess(PROCESS_ALL_ACCESS, FALSE, processId);
+        if (!hProcess)
+        {
+            *console << "[-] Failed to open process. Run as administrator.\n";
+            return false;
+        }
+        pageCache = std::make_shared<PageCache>(std::make_shared<WindowsProcessSource>(hProcess));
+        memory = pageCache;
+
+        // A WOW64 process is 32-bit; otherwise it matches the OS, which is
+        // 64-bit if we are or if we run under WOW64 ourselves
+        BOOL targetWow64 = FALSE, selfWow64 = FALSE;
+        IsWow64Process(hProcess, &targetWow64);
+        IsWow64Process(GetCurrentProcess(), &selfWow64);
+        process64 = !targetWow64 && (sizeof(void*) == 8 || selfWow64);
+
+        // Get process name
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+        PROCESSENTRY32 entry;
+        entry.dwSize = sizeof(PROCESSENTRY32);
+        
+        if (Process32First(snapshot, &entry))
+        {
+            do
+            {
+                if (entry.th32ProcessID == pid)
+                {
+                    processName = entry.szExeFile;
+                    break;
+                }
+            } while (Process32Next(snapshot, &entry));
+        }
+        CloseHandle(snapshot);
+#endif
+
+        *console << "[+] Attached to process: " << processName << " (PID: " << processId << ")\n";
+        return true;
+    }
+
+    // Open a module dump file instead of a live process
+    bool AttachToDump(const std::string& path)
+    {
+        auto source = std::make_shared<DumpFileSource>();
+        if (!source->Open(path))
+        {
+            *console << "[-] Failed to open dump file: " << path << "\n";
+            return false;
+        }
+
+        memory = source;
+        process64 = sizeof(void*) == 8;
+        pageCache.reset();
+        processId = 0;
+        processName = path;
+        *console << "[+] Opened dump: " << path << "\n";
+
+        size_t slash = path.find_last_of("/\\");
+        SetModule(slash == std::string::npos ? path : path.substr(slash + 1), source->Base(), source->Size());
+        return true;
+    }
+
+    // Make a module the scan target
+    void SetModule(const std::string& name, uintptr_t base, size_t size)
+    {
+        moduleName = name;
+        moduleBase = base;
+        moduleSize = size;
+        signatureHits.clear();
+        signaturePassDone = false;
+        targetResults.clear();
+        suffixIndex.reset();
+        xrefIndex.reset();
+        stringTable.reset();
+        functionTable.clear();
+        functionTableLoaded = false;
+        relocations.clear();
+        relocationsLoaded = false;
+        if (pageCache)
+            pageCache->Clear();
+
+        *console << "[+] Module: " << moduleName << "\n";
+        *console << "    Base: 0x" << std::hex << moduleBase << "\n";
+        *console << "    Size: 0x" << moduleSize << std::dec << "\n";
+
+        LoadSections();
+    }
+
+    // Parse the PE headers and plan code scans over the executable sections.
+    // Falls back to the whole module for non-PE images.
+    void LoadSections()
+    {
+        hasPEInfo = false;
+        codeRanges.clear();
+
+        // Nothing enumerated means the source cannot tell; assume it is all readable
+        readableRanges = memory->ReadableRanges(moduleBase, moduleSize);
+        if (readableRanges.empty())
+            readableRanges.push_back({ moduleBase, moduleSize });
+
+        size_t readableBytes = 0;
+        for (const auto& range : readableRanges)
+            readableBytes += range.size;
+        if (readableBytes < moduleSize)
+            *console << "    Readable: " << readableRanges.size() << " range(s), 0x" << std::hex << readableBytes << std::dec
+                      << " bytes (" << (moduleSize ? readableBytes * 100 / moduleSize : 0) << "% of image)\n";
+
+        std::vector<uint8_t> headers(std::min<size_t>(0x1000, moduleSize));
+        if (!headers.empty() && ReadInto(moduleBase, headers.data(), headers.size()) &&
+            ParsePEHeaders(headers.data(), headers.size(), peInfo))
+        {
+            // Large section tables can run past the first page
+            if (peInfo.sizeOfHeaders > headers.size() && peInfo.sizeOfHeaders <= moduleSize)
+            {
+                headers.resize(peInfo.sizeOfHeaders);
+                if (ReadInto(moduleBase, headers.data(), headers.size()))
+                    ParsePEHeaders(headers.data(), headers.size(), peInfo);
+            }
+            hasPEInfo = true;
+        }
+
+        // Machine types other than the two we know fall back to the optional header magic
+        code64 = process64;
+        if (hasPEInfo)
+            code64 = peInfo.machine == ArchX64::kMachine || (peInfo.machine != ArchX86::kMachine && peInfo.is64);
+        *console << "    Architecture: " << (code64 ? ArchX64::kName : ArchX86::kName);
+        if (hasPEInfo)
+            *console << " (machine 0x" << std::hex << peInfo.machine << std::dec << ")\n";
+        else
+            *console << " (process)\n";
+
+        size_t codeBytes = 0;
+        if (hasPEInfo)
+        {
+            for (const auto& section : peInfo.sections)
+            {
+                if (!(section.characteristics & (kSectionExecute | kSectionCode)) || section.rva >= moduleSize)
+                    continue;
+
+                size_t size = std::max(section.virtualSize, section.rawSize);
+                size = std::min(size, moduleSize - section.rva);
+                codeRanges.push_back({ moduleBase + section.rva, size });
+                codeBytes += size;
+            }
+        }
+
+        if (codeRanges.empty())
+        {
+            codeRanges.push_back({ moduleBase, moduleSize });
+            codeBytes = moduleSize;
+            return;
+        }
+
+        *console << "    Code: " << codeRanges.size() << " executable section(s), 0x" << std::hex << codeBytes
+                  << std::dec << " bytes (" << (moduleSize ? codeBytes * 100 / moduleSize : 0) << "% of image)\n";
+    }
+
+    // Is the address inside a non-executable data section (.data, .rdata, .bss)?
+    bool IsDataAddress(uintptr_t address) const
+    {
+        if (!hasPEInfo)
+            return true;
+
+        if (address < moduleBase)
+            return false;
+
+        size_t rva = address - moduleBase;
+        for (const auto& section : peInfo.sections)
+        {
+            if (section.characteristics & kSectionExecute)
+                continue;
+            if (!(section.characteristics & (kSectionInitializedData | kSectionUninitializedData)))
+                continue;
+
+            size_t size = std::max(section.virtualSize, section.rawSize);
+            if (rva >= section.rva && rva < section.rva + size)
+                return true;
+        }
+        return false;
+    }
+
+    // Name, base and size of every module, from one enumeration. Cheap
+    // enough to poll: a read of /proc/<pid>/maps or one toolhelp snapshot.
+    std::vector<LoadedModule> ModuleSnapshot(DWORD pid)
+    {
+        std::vector<LoadedModule> modules;
+#ifndef _WIN32
+        // A shared object spans several mappings; take the lowest start and highest end
+        std::map<std::string, size_t> index;
+        std::vector<uintptr_t> ends;
+        for (const auto& mapping : ReadProcessMaps(pid))
+        {
+            if (mapping.path.empty() || mapping.path[0] != '/')
+                continue;
+
+            std::string name = MappingBaseName(mapping.path);
+            auto it = index.emplace(name, modules.size()).first;
+            if (it->second == modules.size())
+            {
+                modules.push_back({ name, mapping.start, 0 });
+                ends.push_back(mapping.end);
+            }
+            LoadedModule& module = modules[it->second];
+            module.base = std::min(module.base, mapping.start);
+            ends[it->second] = std::max(ends[it->second], mapping.end);
+        }
+        for (size_t i = 0; i < modules.size(); i++)
+            modules[i].size = ends[i] - modules[i].base;
+#else
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPMODULE | TH32CS_SNAPMODULE32, pid);
+        if (snapshot == INVALID_HANDLE_VALUE)
+            return modules;
+
+        MODULEENTRY32 entry;
+        entry.dwSize = sizeof(MODULEENTRY32);
+
+        if (Module32First(snapshot, &entry))
+        {
+            do
+            {
+                modules.push_back({ entry.szModule, reinterpret_cast<uintptr_t>(entry.modBaseAddr), entry.modBaseSize });
+            } while (Module32Next(snapshot, &entry));
+        }
+
+        CloseHandle(snapshot);
+#endif
+        return modules;
+    }
+
+    // Get module info
+    bool GetModuleInfo(const std::string& moduleName)
+    {
+        for (const auto& module : ModuleSnapshot(processId))
+        {
+            if (_stricmp(module.name.c_str(), moduleName.c_str()) == 0)
+            {
+                SetModule(moduleName, module.base, module.size);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Read memory; zero if the address is unreadable
+    template<typename T>
+    T Read(uintptr_t address)
+    {
+        T value{};
+        if (!memory->Read(address, &value, sizeof(T)))
+            value = T{};
+        return value;
+    }
+
+    // Read memory, reporting whether it was readable
+    template<typename T>
+    bool Read(uintptr_t address, T& value)
+    {
+        return memory->Read(address, &value, sizeof(T));
+    }
+
+    // Read bytes
+    std::vector<uint8_t> ReadBytes(uintptr_t address, size_t size)
+    {
+        std::vector<uint8_t> buffer(size);
+        memory->Read(address, buffer.data(), size);
+        return buffer;
+    }
+
+    // Read bytes into an existing buffer
+    bool ReadInto(uintptr_t address, uint8_t* out, size_t size)
+    {
+        return memory->Read(address, out, size);
+    }
+
+    // Readable parts of [address, address + size), from readableRanges
+    std::vector<ScanRange> ReadablePieces(uintptr_t address, size_t size) const
+    {
+        std::vector<ScanRange> pieces;
+        const uintptr_t end = address + size;
+        auto it = std::upper_bound(readableRanges.begin(), readableRanges.end(), address,
+                                   [](uintptr_t value, const ScanRange& range) { return value < range.start + range.size; });
+        for (; it != readableRanges.end() && it->start < end; ++it)
+            AppendRange(pieces, std::max(it->start, address), std::min(it->start + it->size, end));
+        return pieces;
+    }
+
+    // Fill a scan buffer from the readable pieces it covers, in one
+    // scatter read where the source supports it; the gaps are zero-filled.
+    // Returns false if anything had to be zero-filled.
+    bool ReadChunk(uintptr_t address, uint8_t* out, size_t size)
+    {
+        std::vector<ScanRange> pieces = ReadablePieces(address, size);
+        if (pieces.size() == 1 && pieces[0].start == address && pieces[0].size == size)
+            return ReadSkippingPages(address, out, size);
+
+        memset(out, 0, size);
+        if (!memory->ReadPieces(address, out, pieces))
+        {
+            // The address space changed since it was enumerated
+            for (const auto& piece : pieces)
+                ReadSkippingPages(piece.start, out + (piece.start - address), piece.size);
+        }
+        return false;
+    }
+
+    // Read a range, zero-filling and skipping pages that turn out to be
+    // unreadable so one bad page costs 4KB instead of the whole chunk
+    bool ReadSkippingPages(uintptr_t address, uint8_t* out, size_t size)
+    {
+        size_t done = memory->ReadPrefix(address, out, size);
+        const bool complete = done == size;
+        while (done < size)
+        {
+            size_t skip = std::min(PageCache::kPageSize - ((address + done) & (PageCache::kPageSize - 1)), size - done);
+            memset(out + done, 0, skip);
+            done += skip;
+            if (done < size)
+                done += memory->ReadPrefix(address + done, out + done, size - done);
+        }
+        return complete;
+    }
+
+    // Hand the pages around a match in a scan buffer to the page cache, so
+    // resolving it later needs no further reads. `dataAddress` is the
+    // address of data[0].
+    void KeepMatchPages(uintptr_t dataAddress, const uint8_t* data, size_t dataSize, size_t start, size_t length)
+    {
+        if (!pageCache)
+            return;
+
+        // At least one whole instruction, which MemoryOperand rules decode
+        length = std::max<size_t>(length, 15);
+        const uintptr_t pageMask = PageCache::kPageSize - 1;
+        uintptr_t first = std::max(dataAddress, (dataAddress + start) & ~pageMask);
+        uintptr_t last = std::min(dataAddress + dataSize, ((dataAddress + start + length - 1) | pageMask) + 1);
+        pageCache->Store(first, data + (first - dataAddress), last - first);
+    }
+
+    // Start collecting counters and timers. Wraps the current memory source,
+    // so call it after attaching. Behind a page cache the counters sit below
+    // the cache and see only the reads that reach the process.
+    void EnableTelemetry()
+    {
+        if (telemetry)
+            return;
+
+        telemetry = std::make_shared<ScanTelemetry>();
+        if (pageCache)
+        {
+            telemetry->reads = std::make_shared<CountingMemorySource>(pageCache->inner);
+            pageCache->inner = telemetry->reads;
+            return;
+        }
+        telemetry->reads = std::make_shared<CountingMemorySource>(memory);
+        memory = telemetry->reads;
+    }
+
+    // Hand this thread's matcher counters over to the shared totals
+    void FlushThreadCounters()
+    {
+        telemetry->workerCandidates += threadScanCounters.candidates;
+        telemetry->workerCompares += threadScanCounters.fullCompares;
+        threadScanCounters = ScanCounters();
+    }
+
+    // Matcher counters of this thread plus everything flushed by workers
+    ScanCounters TelemetryCounters() const
+    {
+        ScanCounters counters = threadScanCounters;
+        counters.candidates += telemetry->workerCandidates;
+        counters.fullCompares += telemetry->workerCompares;
+        return counters;
+    }
+
+    // Snapshot taken before a measured operation
+    struct OperationProbe
+    {
+        ScanCounters counters;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    OperationProbe BeginOperation() const
+    {
+        OperationProbe probe;
+        if (telemetry)
+        {
+            probe.counters = TelemetryCounters();
+            probe.start = std::chrono::steady_clock::now();
+        }
+        return probe;
+    }
+
+    void EndOperation(const OperationProbe& probe, const char* kind, const char* pattern, size_t patterns,
+                      uint64_t bytesScanned, uintptr_t result)
+    {
+        if (!telemetry)
+            return;
+
+        ScanCounters counters = TelemetryCounters();
+        ScanTelemetry::Operation operation;
+        operation.kind = kind;
+        operation.pattern = pattern;
+        operation.patterns = patterns;
+        operation.bytesScanned = bytesScanned;
+        operation.candidates = counters.candidates - probe.counters.candidates;
+        operation.fullCompares = counters.fullCompares - probe.counters.fullCompares;
+        operation.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - probe.start).count();
+        operation.result = result;
+        telemetry->operations.push_back(operation);
+    }
+
+    // Stream the given ranges through the prefetching reader, in address order.
+    // `overlap` should be the longest pattern length minus one. Chunk offsets
+    // are relative to moduleBase. The callback returns false to stop.
+    template<typename Callback>
+    void ForEachChunk(const std::vector<ScanRange>& ranges, size_t overlap, Callback&& onChunk)
+    {
+        const size_t chunkSize = 0x100000; // 1MB chunks
+
+        for (const auto& range : ranges)
+        {
+            const size_t rangeOffset = range.start - moduleBase;
+
+            // Mapped dumps are scanned in place as one chunk
+            if (const uint8_t* view = memory->View(range.start, range.size))
+            {
+                if (!onChunk(ChunkStream::Chunk{ view, range.size, range.size, rangeOffset }))
+                    return;
+                continue;
+            }
+
+            // ReadChunk zero-fills what it cannot read itself
+            ChunkStream stream([this](uintptr_t address, uint8_t* out, size_t size) { ReadChunk(address, out, size); return true; },
+                               range.start, range.size, chunkSize, overlap);
+
+            ChunkStream::Chunk chunk;
+            while (stream.Next(chunk))
+            {
+                chunk.offset += rangeOffset;
+                if (!onChunk(chunk))
+                {
+                    stream.Cancel();
+                    return;
+                }
+            }
+        }
+    }
+
+    // Change the number of scan threads
+    void SetThreadCount(size_t count)
+    {
+        threadCount = std::max<size_t>(count, 1);
+        if (pool && pool->Size() != threadCount)
+            pool.reset();
+    }
+
+    ThreadPool* GetPool()
+    {
+        if (threadCount <= 1)
+            return nullptr;
+        if (!pool)
+            pool = std::make_shared<ThreadPool>(threadCount);
+        return pool.get();
+    }
+
+    // Split ranges into 1MB tasks in address order, leaving out unreadable ones
+    std::vector<ScanTask> PlanScanTasks(const std::vector<ScanRange>& ranges, size_t overlap) const
+    {
+        const size_t chunkSize = 0x100000; // 1MB chunks
+
+        std::vector<ScanTask> tasks;
+        for (const auto& range : ranges)
+        {
+            for (size_t offset = 0; offset < range.size; offset += chunkSize)
+            {
+                // Nothing to scan in chunks that are entirely unreadable
+                if (ReadablePieces(range.start + offset, std::min(chunkSize, range.size - offset)).empty())
+                    continue;
+
+                ScanTask task;
+                task.address = range.start + offset;
+                task.ownedSize = std::min(chunkSize, range.size - offset);
+                task.readSize = std::min(chunkSize + overlap, range.size - offset);
+                task.offset = task.address - moduleBase;
+                tasks.push_back(task);
+            }
+        }
+        return tasks;
+    }
+
+    // Run onChunk(taskIndex, chunk) for every task on the thread pool.
+    // skip(taskIndex) is checked first so callers can drop tasks that can no
+    // longer improve on a result already found.
+    template<typename Callback, typename Skip>
+    void RunScanTasks(const std::vector<ScanTask>& tasks, Callback&& onChunk, Skip&& skip)
+    {
+        GetPool()->ParallelFor(tasks.size(), [&](size_t index)
+        {
+            if (skip(index))
+                return;
+
+            const ScanTask& task = tasks[index];
+            const uint8_t* data = memory->View(task.address, task.readSize);
+
+            thread_local std::vector<uint8_t> buffer;
+            if (!data)
+            {
+                buffer.resize(task.readSize);
+                ReadChunk(task.address, buffer.data(), task.readSize);
+                data = buffer.data();
+            }
+
+            onChunk(index, ChunkStream::Chunk{ data, task.readSize, task.ownedSize, task.offset });
+
+            if (telemetry)
+                FlushThreadCounters();
+        });
+    }
+
+    // Pattern to bytes
+    std::vector<int> PatternToBytes(const std::string& pattern)
+    {
+        std::vector<int> bytes;
+        char* start = const_cast<char*>(pattern.c_str());
+        char* end = start + pattern.length();
+
+        for (char* current = start; current < end; ++current)
+        {
+            if (*current == '?')
+            {
+                ++current;
+                if (current < end && *current == '?')
+                    ++current;
+                bytes.push_back(-1);
+            }
+            else
+            {
+                bytes.push_back(strtoul(current, &current, 16));
+            }
+        }
+
+        return bytes;
+    }
+
+    // Find pattern
+    uintptr_t FindPattern(const std::string& pattern)
+    {
+        // Signatures are instruction bytes, so only executable sections are scanned
+        return FindPattern(pattern, codeRanges);
+    }
+
+    // Find pattern within specific ranges
+    uintptr_t FindPattern(const std::string& pattern, const std::vector<ScanRange>& ranges)
+    {
+        RuntimeSignature signature(pattern, PatternToBytes(pattern));
+        return FindPattern(signature.View(), ranges);
+    }
+
+    // Find a compiled signature; no parsing or allocation besides the scan itself
+    uintptr_t FindPattern(const SignatureView& patternBytes, const std::vector<ScanRange>& ranges)
+    {
+        if (patternBytes.size() == 0)
+            return 0;
+
+        OperationProbe probe = BeginOperation();
+        std::atomic<uint64_t> bytesScanned(0);
+        uintptr_t result = 0;
+
+        if (GetPool())
+        {
+            // Every task finds its own first match; the lowest task index wins.
+            // Tasks above an already matched one are skipped.
+            auto tasks = PlanScanTasks(ranges, patternBytes.size() - 1);
+            std::vector<uintptr_t> taskHits(tasks.size(), 0);
+            std::atomic<size_t> firstTask(SIZE_MAX);
+
+            RunScanTasks(tasks, [&](size_t index, const ChunkStream::Chunk& chunk)
+            {
+                bytesScanned += chunk.ownedSize;
+                size_t i = FindFirst(chunk.data, chunk.size, patternBytes);
+                if (i != kNoMatch)
+                {
+                    KeepMatchPages(moduleBase + chunk.offset, chunk.data, chunk.size, i, patternBytes.size());
+                    taskHits[index] = moduleBase + chunk.offset + i;
+                    AtomicMin(firstTask, index);
+                }
+            }, [&](size_t index) { return index > firstTask.load(); });
+
+            if (firstTask != SIZE_MAX)
+                result = taskHits[firstTask];
+        }
+        else
+        {
+            ForEachChunk(ranges, patternBytes.size() - 1, [&](const ChunkStream::Chunk& chunk)
+            {
+                bytesScanned += chunk.ownedSize;
+
+                // Vectorized anchor search, full masked compare only on candidates
+                size_t i = FindFirst(chunk.data, chunk.size, patternBytes);
+                if (i != kNoMatch)
+                {
+                    KeepMatchPages(moduleBase + chunk.offset, chunk.data, chunk.size, i, patternBytes.size());
+                    result = moduleBase + chunk.offset + i;
+                    return false;
+                }
+                return true;
+            });
+        }
+
+        EndOperation(probe, "findPattern", patternBytes.text, 1, bytesScanned, result);
+        return result;
+    }
+
+    // Every match of a signature as sorted RVAs, collected in one pass
+    std::vector<uint32_t> FindAllPattern(const SignatureView& patternBytes, const std::vector<ScanRange>& ranges)
+    {
+        std::vector<uint32_t> rvas;
+        if (patternBytes.size() == 0)
+            return rvas;
+
+        OperationProbe probe = BeginOperation();
+        std::atomic<uint64_t> bytesScanned(0);
+
+        // Matches starting in a chunk's overlap belong to the next chunk
+        auto collect = [&](const ChunkStream::Chunk& chunk, std::vector<uint32_t>& out)
+        {
+            bytesScanned += chunk.ownedSize;
+            for (size_t pos = 0; pos < chunk.ownedSize;)
+            {
+                size_t i = FindFirst(chunk.data + pos, chunk.size - pos, patternBytes);
+                if (i == kNoMatch || pos + i >= chunk.ownedSize)
+                    break;
+                KeepMatchPages(moduleBase + chunk.offset, chunk.data, chunk.size, pos + i, patternBytes.size());
+                out.push_back(static_cast<uint32_t>(chunk.offset + pos + i));
+                pos += i + 1;
+            }
+        };
+
+        if (GetPool())
+        {
+            auto tasks = PlanScanTasks(ranges, patternBytes.size() - 1);
+            std::vector<std::vector<uint32_t>> taskMatches(tasks.size());
+            RunScanTasks(tasks, [&](size_t index, const ChunkStream::Chunk& chunk)
+            {
+                collect(chunk, taskMatches[index]);
+            }, [](size_t) { return false; });
+
+            size_t total = 0;
+            for (const auto& matches : taskMatches)
+                total += matches.size();
+            rvas.reserve(total);
+            for (const auto& matches : taskMatches)
+                rvas.insert(rvas.end(), matches.begin(), matches.end());
+        }
+        else
+        {
+            ForEachChunk(ranges, patternBytes.size() - 1, [&](const ChunkStream::Chunk& chunk)
+            {
+                collect(chunk, rvas);
+                return true;
+            });
+        }
+
+        EndOperation(probe, "findAllPattern", patternBytes.text, 1, bytesScanned, rvas.empty() ? 0 : moduleBase + rvas[0]);
+        return rvas;
+    }
+
+    // A site within some number of differing bytes of a signature
+    struct ApproximateMatch
+    {
+        uint32_t rva;
+        uint32_t distance;
+    };
+
+    // Every site within maxMismatches differing bytes of a signature, closest
+    // first and in address order within a distance. Empty if the signature
+    // cannot be matched approximately (see ApproximateMatcher::Compile).
+    std::vector<ApproximateMatch> FindApproximate(const SignatureView& patternBytes, size_t maxMismatches,
+                                                  const std::vector<ScanRange>& ranges)
+    {
+        std::vector<ApproximateMatch> matches;
+        ApproximateMatcher matcher;
+        if (!matcher.Compile(patternBytes, maxMismatches))
+            return matches;
+
+        OperationProbe probe = BeginOperation();
+        std::atomic<uint64_t> bytesScanned(0);
+
+        auto collect = [&](const ChunkStream::Chunk& chunk, std::vector<ApproximateMatch>& out)
+        {
+            bytesScanned += chunk.ownedSize;
+            matcher.Scan(chunk.data, chunk.size, [&](size_t start, size_t distance)
+            {
+                if (start < chunk.ownedSize)
+                    out.push_back({ static_cast<uint32_t>(chunk.offset + start), static_cast<uint32_t>(distance) });
+            });
+        };
+
+        if (GetPool())
+        {
+            auto tasks = PlanScanTasks(ranges, matcher.Length() - 1);
+            std::vector<std::vector<ApproximateMatch>> taskMatches(tasks.size());
+            RunScanTasks(tasks, [&](size_t index, const ChunkStream::Chunk& chunk)
+            {
+                collect(chunk, taskMatches[index]);
+            }, [](size_t) { return false; });
+
+            for (const auto& list : taskMatches)
+                matches.insert(matches.end(), list.begin(), list.end());
+        }
+        else
+        {
+            ForEachChunk(ranges, matcher.Length() - 1, [&](const ChunkStream::Chunk& chunk)
+            {
+                collect(chunk, matches);
+                return true;
+            });
+        }
+
+        std::stable_sort(matches.begin(), matches.end(),
+                         [](const ApproximateMatch& a, const ApproximateMatch& b) { return a.distance < b.distance; });
+
+        EndOperation(probe, "findApproximate", patternBytes.text, 1, bytesScanned, matches.empty() ? 0 : moduleBase + matches[0].rva);
+        return matches;
+    }
+
+    // Current signature database
+    const SignatureDatabase& Signatures()
+    {
+        if (!signatureDb)
+            signatureDb = BuiltinSignatures();
+        return *signatureDb;
+    }
+
+    // Switch to another signature database; drops results of the old one
+    void SetSignatures(std::shared_ptr<const SignatureDatabase> database)
+    {
+        signatureDb = std::move(database);
+        signatureSet.reset();
+        signatureHits.clear();
+        signaturePassDone = false;
+    }
+
+    // Compile the signatures of every target that can match code of
+    // architecture Arch, duplicates removed
+    template<typename Arch>
+    static std::shared_ptr<const SignatureSet> BuildSignatureSet(std::shared_ptr<const SignatureDatabase> database)
+    {
+        auto set = std::make_shared<SignatureSet>();
+        set->database = database;
+        set->x64 = Arch::kIs64;
+
+        std::map<std::string, size_t> seen;
+        for (size_t target = 0; target < database->TargetCount(); target++)
+        {
+            for (size_t index = 0; index < database->PatternCount(target); index++)
+            {
+                // func signatures are looked up in the string table, not scanned for
+                const TargetSignature signature = database->Pattern(target, index);
+                const SignatureView& view = signature.view;
+                if (signature.rule.kind == ResolveKind::StringFunction)
+                    continue;
+                if (!SignatureFits<Arch>(signature))
+                {
+                    set->skipped++;
+                    continue;
+                }
+                if (seen.emplace(view.text, set->patterns.size()).second)
+                    set->patterns.push_back(view);
+            }
+        }
+
+        for (const auto& pattern : set->patterns)
+            set->matcher.AddPattern(pattern);
+        set->matcher.Compile();
+        return set;
+    }
+
+    static std::shared_ptr<const SignatureSet> BuildSignatureSet(std::shared_ptr<const SignatureDatabase> database, bool x64)
+    {
+        return x64 ? BuildSignatureSet<ArchX64>(std::move(database)) : BuildSignatureSet<ArchX86>(std::move(database));
+    }
+
+    // Scan the module once for every signature of every target.
+    // Collects every match into signatureMatches and the lowest match address
+    // of each pattern into signatureHits.
+    void RunSignaturePass()
+    {
+        const SignatureDatabase& database = Signatures();
+        if (!signatureSet || signatureSet->database.get() != &database || signatureSet->x64 != code64)
+        {
+            signatureSet = BuildSignatureSet(signatureDb, code64);
+            if (signatureSet->skipped)
+                *console << "    [*] Skipping " << signatureSet->skipped << " signature(s) that cannot match "
+                          << (code64 ? ArchX64::kName : ArchX86::kName) << " code\n";
+        }
+
+        const std::vector<SignatureView>& allPatterns = signatureSet->patterns;
+        const MultiPatternScanner& matcher = signatureSet->matcher;
+
+        const size_t overlap = matcher.MaxPatternLength() - 1;
+        OperationProbe probe = BeginOperation();
+        std::atomic<uint64_t> bytesScanned(0);
+
+        // Matches are packed as (pattern ID << 32 | RVA), in address order per
+        // pattern, so no per-match allocation happens beyond vector growth
+        std::vector<std::vector<uint64_t>> taskMatches;
+
+        // Only a pattern's first match is resolved right away, so only its
+        // pages go to the page cache; copying them for every match would
+        // contend on the cache and evict pages still needed. firstTask[id] is
+        // the lowest task that kept pages for pattern `id`.
+        std::unique_ptr<std::atomic<size_t>[]> firstTask(new std::atomic<size_t>[allPatterns.size()]);
+        for (size_t id = 0; id < allPatterns.size(); id++)
+            firstTask[id] = SIZE_MAX;
+        auto claimFirst = [&](size_t id, size_t index)
+        {
+            size_t current = firstTask[id].load();
+            while (index < current && !firstTask[id].compare_exchange_weak(current, index))
+            {
+            }
+            return index < current;
+        };
+
+        if (GetPool())
+        {
+            // Every task has to run since all matches are wanted; each fills
+            // its own list and the lists are joined in task (address) order
+            auto tasks = PlanScanTasks(codeRanges, overlap);
+            taskMatches.resize(tasks.size());
+
+            RunScanTasks(tasks, [&](size_t index, const ChunkStream::Chunk& chunk)
+            {
+                bytesScanned += chunk.ownedSize;
+                std::vector<uint64_t>& matches = taskMatches[index];
+                std::vector<bool> seen(allPatterns.size());
+                matcher.Scan(chunk.data, chunk.size, [&](size_t id, size_t start)
+                {
+                    if (start >= chunk.ownedSize)
+                        return;
+                    if (!seen[id] && claimFirst(id, index))
+                        KeepMatchPages(moduleBase + chunk.offset, chunk.data, chunk.size, start, allPatterns[id].size());
+                    seen[id] = true;
+                    matches.push_back(static_cast<uint64_t>(id) << 32 | (chunk.offset + start));
+                });
+            }, [](size_t) { return false; });
+        }
+        else
+        {
+            taskMatches.resize(1);
+            ForEachChunk(codeRanges, overlap, [&](const ChunkStream::Chunk& chunk)
+            {
+                bytesScanned += chunk.ownedSize;
+
+                // Matches starting in the overlap belong to the next chunk
+                matcher.Scan(chunk.data, chunk.size, [&](size_t id, size_t start)
+                {
+                    if (start >= chunk.ownedSize)
+                        return;
+                    if (claimFirst(id, 0))
+                        KeepMatchPages(moduleBase + chunk.offset, chunk.data, chunk.size, start, allPatterns[id].size());
+                    taskMatches[0].push_back(static_cast<uint64_t>(id) << 32 | (chunk.offset + start));
+                });
+                return true;
+            });
+        }
+
+        signatureMatches.Build(allPatterns.size(), taskMatches);
+
+        EndOperation(probe, "signaturePass", "", allPatterns.size(), bytesScanned, 0);
+
+        signatureHits.clear();
+        for (size_t id = 0; id < allPatterns.size(); id++)
+        {
+            const MatchList::Span span = signatureMatches.Of(id);
+            signatureHits[allPatterns[id].text] = span.count ? moduleBase + span.rvas[0] : 0;
+        }
+        signaturePassDone = true;
+    }
+
+    // Every match RVA of a pattern, sorted. Served from the signature pass
+    // for built-in signatures, otherwise found with a find-all scan.
+    std::vector<uint32_t> AllMatches(const SignatureView& pattern)
+    {
+        if (!signaturePassDone)
+            RunSignaturePass();
+
+        const auto& patterns = signatureSet->patterns;
+        for (size_t id = 0; id < patterns.size(); id++)
+        {
+            if (strcmp(patterns[id].text, pattern.text) == 0)
+            {
+                const MatchList::Span span = signatureMatches.Of(id);
+                return std::vector<uint32_t>(span.rvas, span.rvas + span.count);
+            }
+        }
+
+        return FindAllPattern(pattern, codeRanges);
+    }
+
+    // First match of a pattern, served from the signature pass when possible
+    uintptr_t LookupPattern(const SignatureView& pattern)
+    {
+        if (!signaturePassDone)
+            RunSignaturePass();
+
+        auto it = signatureHits.find(pattern.text);
+        if (it != signatureHits.end())
+            return it->second;
+
+        return FindPattern(pattern, codeRanges);
+    }
+
+    // The rule a MemoryOperand signature stands for at `site`, by decoding
+    // the instruction there; other rules are returned as they are. Kind 0 if
+    // the instruction does not decode or refers to no address.
+    ResolveRule ConcreteRule(const ResolveRule& rule, uintptr_t site)
+    {
+        if (rule.kind != ResolveKind::MemoryOperand)
+            return rule;
+
+        uint8_t code[15];
+        DecodedInstruction instruction;
+        ResolveRule concrete = {};
+        const bool x64 = CodeIs64();
+        if (DecodeInstruction(code, memory->ReadPrefix(site, code, sizeof(code)), x64, instruction))
+        {
+            bool immediateIsAddress = !x64 && instruction.immSize == 4 &&
+                                      IsAddressImmediate(static_cast<uint32_t>(site - moduleBase + instruction.immOffset));
+            AddressRule(instruction, immediateIsAddress, concrete);
+        }
+        return concrete;
+    }
+
+    // Resolve the global a signature hit refers to; 0 if the operand is
+    // unreadable or missing. Once the xref index is built this is a lookup;
+    // otherwise, or where the index's sweep did not land on the instruction,
+    // the operand lies inside the matched bytes and the pages the scan kept.
+    uintptr_t ResolveSite(const ResolveRule& rule, uintptr_t site)
+    {
+        if (rule.kind == ResolveKind::MemoryOperand && xrefIndex && site - moduleBase < moduleSize)
+        {
+            auto references = xrefIndex->From(static_cast<uint32_t>(site - moduleBase));
+            if (references.first != references.second)
+                return moduleBase + references.first->target;
+        }
+
+        const ResolveRule concrete = ConcreteRule(rule, site);
+        if (concrete.kind == ResolveKind::RipRelative)
+        {
+            int32_t displacement;
+            if (!Read(site + concrete.operandOffset, displacement))
+                return 0;
+            return site + concrete.instructionLength + displacement;
+        }
+
+        uint32_t absolute;
+        if (concrete.kind != ResolveKind::Absolute32 || !Read(site + concrete.operandOffset, absolute))
+            return 0;
+        return absolute;
+    }
+
+    // Resolve a signature hit and record it if it lands in a data section
+    bool AcceptHit(const std::string& target, const TargetSignature& signature, uintptr_t site)
+    {
+        uintptr_t address = ResolveSite(signature.rule, site);
+        const char* tag = ConcreteRule(signature.rule, site).kind == ResolveKind::RipRelative ? "[x64] " : "[x86] ";
+        *console << "    " << tag << "Found at: 0x" << std::hex << site << "\n";
+        if (!address)
+        {
+            *console << std::dec << "    [!] No readable address operand, skipping\n";
+            return false;
+        }
+        *console << "    Resolved: 0x" << address << std::dec << "\n";
+        if (!IsDataAddress(address))
+        {
+            *console << "    [!] Resolved outside .data/.rdata, skipping\n";
+            return false;
+        }
+
+        targetResults[target] = { address, site, signature.view.text };
+        return true;
+    }
+
+    // Try a target's signatures in priority order and resolve the first usable hit
+    uintptr_t ScanTarget(const std::string& target)
+    {
+        *console << "\n[*] Scanning for Garry's Mod " << target << "...\n";
+
+        const SignatureDatabase& database = Signatures();
+        const size_t index = database.FindTarget(target);
+        for (size_t i = 0; index != SIZE_MAX && i < database.PatternCount(index); i++)
+        {
+            const TargetSignature signature = database.Pattern(index, i);
+            const SignatureView& pattern = signature.view;
+            if (!CanMatch(signature))
+                continue;
+            *console << "    Trying pattern: " << std::string(pattern.text).substr(0, 20) << "...\n";
+            auto started = telemetry ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+            const bool byString = signature.rule.kind == ResolveKind::StringFunction;
+            uintptr_t result = byString ? 0 : LookupPattern(pattern);
+            bool accepted = byString ? ResolveStringTarget(target, signature) : result && AcceptHit(target, signature, result);
+
+            // The first hit can be a look-alike that resolves elsewhere; check the pattern's other hits
+            // in address order without printing each, and report only the one accepted. Patterns the
+            // signature pass did not cover cost another scan of the code here.
+            size_t rejected = 0;
+            const bool rescanned = !byString && result && !accepted && !signatureHits.count(pattern.text);
+            if (!byString && result && !accepted)
+            {
+                rejected = 1;
+                for (uint32_t rva : AllMatches(pattern))
+                {
+                    const uintptr_t site = moduleBase + rva;
+                    if (site == result)
+                        continue;
+                    const uintptr_t address = ResolveSite(signature.rule, site);
+                    if (address && IsDataAddress(address) && AcceptHit(target, signature, site))
+                    {
+                        result = site;
+                        accepted = true;
+                        break;
+                    }
+                    rejected++;
+                }
+                if (!accepted && rejected > 1)
+                    *console << "    [!] " << rejected << " hits rejected\n";
+            }
+            if (byString && accepted)
+                result = targetResults[target].site;
+
+            if (telemetry)
+            {
+                ScanTelemetry::Attempt attempt;
+                attempt.target = target;
+                attempt.pattern = pattern.text;
+                attempt.source = byString ? "strings" : signatureHits.count(pattern.text) ? "signaturePass" : "findPattern";
+                attempt.site = result;
+                attempt.accepted = accepted;
+                attempt.rejected = rejected;
+                attempt.rescanned = rescanned;
+                attempt.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+                telemetry->attempts.push_back(attempt);
+            }
+
+            if (accepted)
+            {
+                if (!byString)
+                    CheckUniqueness(target, signature);
+                return targetResults[target].address;
+            }
+        }
+
+        if (approximateMismatches && ScanTargetApproximate(target))
+            return targetResults[target].address;
+
+        targetResults[target] = TargetResult();
+        *console << "    [-] Not found\n";
+        return 0;
+    }
+
+    // Fallback for a target none of whose signatures match exactly: rank
+    // every site within approximateMismatches differing bytes of any of its
+    // signatures and take the closest one that resolves into a data section.
+    // Ties go to the higher priority signature, then the lower address.
+    bool ScanTargetApproximate(const std::string& target)
+    {
+        *console << "    [*] No exact match, trying up to " << approximateMismatches << " mismatching bytes...\n";
+
+        struct Candidate
+        {
+            size_t distance;
+            size_t pattern;
+            uintptr_t site;
+        };
+        std::vector<TargetSignature> signatures = TargetSignatures(target);
+        std::vector<Candidate> candidates;
+        for (size_t i = 0; i < signatures.size(); i++)
+        {
+            if (signatures[i].rule.kind == ResolveKind::StringFunction)
+                continue;
+            for (const auto& match : FindApproximate(signatures[i].view, approximateMismatches, codeRanges))
+                candidates.push_back({ match.distance, i, moduleBase + match.rva });
+        }
+        std::stable_sort(candidates.begin(), candidates.end(),
+                         [](const Candidate& a, const Candidate& b) { return a.distance < b.distance; });
+
+        for (size_t i = 0; i < candidates.size() && i < 5; i++)
+        {
+            *console << "      " << candidates[i].distance << " off: 0x" << std::hex << candidates[i].site << std::dec << "  "
+                      << std::string(signatures[candidates[i].pattern].view.text).substr(0, 20) << "...\n";
+        }
+
+        // Only the closest few are worth resolving
+        for (size_t i = 0; i < candidates.size() && i < 16; i++)
+        {
+            const Candidate& candidate = candidates[i];
+            if (AcceptHit(target, signatures[candidate.pattern], candidate.site))
+            {
+                targetResults[target].mismatches = candidate.distance;
+                *console << "    [!] Approximate match, " << candidate.distance << " byte(s) differ from the signature\n";
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Resolve every match of a target's winning pattern and count the distinct
+    // globals they point at. More than one means the signature is ambiguous and
+    // the first match may not be the right one.
+    void CheckUniqueness(const std::string& target, const TargetSignature& signature)
+    {
+        std::vector<uint32_t> rvas = AllMatches(signature.view);
+        std::vector<uintptr_t> globals;
+        globals.reserve(rvas.size());
+        for (uint32_t rva : rvas)
+        {
+            uintptr_t address = ResolveSite(signature.rule, moduleBase + rva);
+            if (address && IsDataAddress(address))
+                globals.push_back(address);
+        }
+        std::sort(globals.begin(), globals.end());
+        globals.erase(std::unique(globals.begin(), globals.end()), globals.end());
+
+        TargetResult& result = targetResults[target];
+        result.matches = rvas.size();
+        result.globals = globals.size();
+
+        if (result.globals > 1)
+            *console << "    [!] Ambiguous: " << result.matches << " matches resolve to " << result.globals << " different globals\n";
+        else
+            *console << "    Matches: " << result.matches << " (unique)\n";
+    }
+
+    // "unique", "ambiguous(<globals>)", "missing", or "unchecked" for results
+    // taken from the cache or a rescan
+    static std::string Uniqueness(const TargetResult& result)
+    {
+        if (!result.address)
+            return "missing";
+        if (result.mismatches)
+            return "approximate(" + std::to_string(result.mismatches) + ")";
+        if (!result.globals)
+            return "unchecked";
+        if (result.globals == 1)
+            return "unique";
+        return "ambiguous(" + std::to_string(result.globals) + ")";
+    }
+
+    // Instruction sites (RVAs) from the [Sites] section of a previous SaveResults file
+    std::map<std::string, uintptr_t> LoadPreviousSites(const std::string& filename)
+    {
+        std::map<std::string, uintptr_t> sites;
+        std::ifstream file(filename);
+        std::string line;
+        bool inSites = false;
+
+        while (std::getline(file, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (!line.empty() && line[0] == '[')
+            {
+                inSites = line.compare(0, 7, "[Sites]") == 0;
+                continue;
+            }
+
+            size_t eq = line.find('=');
+            if (!inSites || eq == std::string::npos)
+                continue;
+
+            uintptr_t rva = strtoull(line.substr(eq + 1).c_str(), nullptr, 16);
+            if (rva)
+                sites[line.substr(0, eq)] = rva;
+        }
+        return sites;
+    }
+
+    // Parts of [start, end) that lie in executable sections
+    std::vector<ScanRange> ClipToCode(uintptr_t start, uintptr_t end) const
+    {
+        std::vector<ScanRange> clipped;
+        for (const auto& range : codeRanges)
+        {
+            uintptr_t from = std::max(start, range.start);
+            uintptr_t to = std::min(end, range.start + range.size);
+            if (from < to)
+                clipped.push_back({ from, to - from });
+        }
+        return clipped;
+    }
+
+    // Search outward from where a target's instruction was in the previous
+    // build, in windows of +-4KB growing x4 up to +-4MB. Only the newly added
+    // bytes are read each round. Falls back to a full scan if nothing resolves.
+    uintptr_t RescanTarget(const std::string& target, uintptr_t previousSiteRva)
+    {
+        std::vector<TargetSignature> patterns = TargetSignatures(target);
+        patterns.erase(std::remove_if(patterns.begin(), patterns.end(),
+                                      [](const TargetSignature& pattern) { return pattern.rule.kind == ResolveKind::StringFunction; }),
+                       patterns.end());
+        *console << "\n[*] Rescanning for Garry's Mod " << target << " near RVA 0x" << std::hex << previousSiteRva
+                  << std::dec << "...\n";
+
+        if (patterns.empty())
+            return ScanTarget(target);
+
+        MultiPatternScanner matcher;
+        for (const auto& pattern : patterns)
+            matcher.AddPattern(pattern.view);
+        matcher.Compile();
+        const size_t overlap = matcher.MaxPatternLength() - 1;
+
+        size_t codeBytes = 0;
+        for (const auto& range : codeRanges)
+            codeBytes += range.size;
+
+        const uintptr_t moduleEnd = moduleBase + moduleSize;
+        const uintptr_t center = moduleBase + std::min<uintptr_t>(previousSiteRva, moduleSize);
+        uintptr_t lo = center, hi = center;
+        size_t touched = 0;
+
+        // Nearest hit to the previous site for every pattern
+        std::vector<uintptr_t> nearest(patterns.size(), 0);
+        auto distance = [&](uintptr_t address) { return address > center ? address - center : center - address; };
+
+        auto report = [&](const char* how)
+        {
+            *console << "    " << how << ", touched 0x" << std::hex << touched << std::dec << " bytes ("
+                      << std::fixed << std::setprecision(2) << (codeBytes ? touched * 100.0 / codeBytes : 0.0)
+                      << "% of code)\n" << std::defaultfloat;
+        };
+
+        for (size_t window = 0x1000; window <= 0x400000; window *= 4)
+        {
+            uintptr_t newLo = center - std::min<uintptr_t>(window, center - moduleBase);
+            uintptr_t newHi = center + std::min<uintptr_t>(window, moduleEnd - center);
+
+            // Only the two slices this window added
+            std::vector<ScanRange> slices = ClipToCode(newLo, lo);
+            for (const auto& range : ClipToCode(hi, newHi))
+                slices.push_back(range);
+            lo = newLo;
+            hi = newHi;
+
+            for (const auto& slice : slices)
+            {
+                // Unreadable pages are zero-filled, as in a full scan, so one bad page doesn't drop the slice
+                size_t readSize = slice.size + std::min<size_t>(overlap, moduleEnd - (slice.start + slice.size));
+                if (ReadablePieces(slice.start, readSize).empty())
+                    continue;
+                std::vector<uint8_t> bytes(readSize);
+                ReadChunk(slice.start, bytes.data(), readSize);
+                touched += readSize;
+
+                matcher.Scan(bytes.data(), bytes.size(), [&](size_t id, size_t start)
+                {
+                    uintptr_t address = slice.start + start;
+                    if (start < slice.size && (!nearest[id] || distance(address) < distance(nearest[id])))
+                    {
+                        KeepMatchPages(slice.start, bytes.data(), bytes.size(), start, patterns[id].view.size());
+                        nearest[id] = address;
+                    }
+                });
+            }
+
+            for (size_t id = 0; id < patterns.size(); id++)
+            {
+                if (nearest[id] && AcceptHit(target, patterns[id], nearest[id]))
+                {
+                    report("Found within window");
+                    return targetResults[target].address;
+                }
+                nearest[id] = 0;
+            }
+        }
+
+        touched += codeBytes;
+        report("Not near previous site, full scan");
+        return ScanTarget(target);
+    }
+
+    // Suffix array over the module's code, built on first use
+    const SuffixIndex& CodeIndex()
+    {
+        if (!suffixIndex)
+        {
+            auto start = std::chrono::steady_clock::now();
+            suffixIndex = std::make_shared<SuffixIndex>();
+            suffixIndex->Build(codeRanges, [this](uintptr_t address, uint8_t* out, size_t size) { ReadChunk(address, out, size); });
+            *console << "[+] Indexed 0x" << std::hex << suffixIndex->Size() << std::dec << " bytes of code in " << std::fixed
+                      << std::setprecision(0) << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+                      << " ms\n" << std::defaultfloat;
+        }
+        return *suffixIndex;
+    }
+
+    // Readable memory to build a pointer map from: the whole process, or
+    // the module itself for dumps
+    std::vector<ScanRange> SnapshotRanges()
+    {
+        if (!processId)
+            return readableRanges;
+        return memory->ReadableRanges(0, SIZE_MAX);
+    }
+
+    // Whether the module's code is x64, as chosen by LoadSections
+    bool CodeIs64() const
+    {
+        return code64;
+    }
+
+    // Whether a signature can match the module's code at all
+    bool CanMatch(const TargetSignature& signature) const
+    {
+        return code64 ? SignatureFits<ArchX64>(signature) : SignatureFits<ArchX86>(signature);
+    }
+
+    // Cross-reference index of the module's code, built on first use
+    const XrefIndex& Xrefs()
+    {
+        if (!xrefIndex)
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto index = std::make_shared<XrefIndex>();
+            std::vector<uint8_t> code;
+            size_t total = 0;
+            for (const auto& range : codeRanges)
+            {
+                code.resize(range.size);
+                ReadChunk(range.start, code.data(), code.size());
+                index->Add(code.data(), code.size(), static_cast<uint32_t>(range.start - moduleBase), CodeIs64(), moduleBase,
+                           moduleSize, [this](uint32_t rva) { return IsAddressImmediate(rva); });
+                total += range.size;
+            }
+            index->Finish();
+            xrefIndex = index;
+            *console << "[+] Indexed " << xrefIndex->Size() << " references in 0x" << std::hex << total << std::dec
+                      << " bytes of code in " << std::fixed << std::setprecision(0)
+                      << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+                      << " ms\n" << std::defaultfloat;
+        }
+        return *xrefIndex;
+    }
+
+    // RVAs patched by base relocations, from the PE relocation directory
+    const std::vector<uint32_t>& Relocations()
+    {
+        if (relocationsLoaded)
+            return relocations;
+        relocationsLoaded = true;
+
+        if (!hasPEInfo || !peInfo.relocationRva || !peInfo.relocationSize || peInfo.relocationRva >= moduleSize)
+            return relocations;
+
+        std::vector<uint8_t> table(std::min<size_t>(peInfo.relocationSize, moduleSize - peInfo.relocationRva));
+        if (!ReadInto(moduleBase + peInfo.relocationRva, table.data(), table.size()))
+            return relocations;
+
+        // Blocks of { page RVA, block size, 16-bit entries of type << 12 | offset }
+        for (size_t at = 0; at + 8 <= table.size();)
+        {
+            uint32_t page, blockSize;
+            memcpy(&page, table.data() + at, 4);
+            memcpy(&blockSize, table.data() + at + 4, 4);
+            if (blockSize < 8 || blockSize > table.size() - at)
+                break;
+
+            for (size_t entry = at + 8; entry + 2 <= at + blockSize; entry += 2)
+            {
+                uint16_t value;
+                memcpy(&value, table.data() + entry, 2);
+                if ((value >> 12) == 3 || (value >> 12) == 10) // HIGHLOW, DIR64
+                    relocations.push_back(page + (value & 0xFFF));
+            }
+            at += blockSize;
+        }
+        std::sort(relocations.begin(), relocations.end());
+        return relocations;
+    }
+
+    // Does a relocated address start at `rva`? For 32-bit code without
+    // relocations, any imm32 is taken as a possible address.
+    bool IsAddressImmediate(uint32_t rva)
+    {
+        const std::vector<uint32_t>& fixups = Relocations();
+        return fixups.empty() || std::binary_search(fixups.begin(), fixups.end(), rva);
+    }
+
+    // Is the byte at `rva` part of a relocated address?
+    bool IsRelocated(uint32_t rva)
+    {
+        const std::vector<uint32_t>& fixups = Relocations();
+        const uint32_t width = code64 ? sizeof(ArchX64::Pointer) : sizeof(ArchX86::Pointer);
+        auto it = std::upper_bound(fixups.begin(), fixups.end(), rva);
+        return it != fixups.begin() && rva - *(it - 1) < width;
+    }
+
+    // A signature made by GenerateSignature
+    struct GeneratedSignature
+    {
+        std::string pattern;
+        bool hasRule = false;       // the first instruction has a memory operand to resolve
+        ResolveRule rule = {};
+        size_t matches = 0;         // 1 when unique
+    };
+
+    // Shortest wildcard signature starting at the instruction at `site` that
+    // matches nowhere else in the module's code. Branch displacements,
+    // RIP-relative and absolute addresses and relocated bytes are wildcarded,
+    // so the signature survives the module being rebuilt or rebased.
+    bool GenerateSignature(uintptr_t site, GeneratedSignature& out)
+    {
+        const size_t maxLength = 64;
+        const bool x64 = CodeIs64();
+
+        const SuffixIndex& index = CodeIndex();
+        const size_t at = index.TextOffset(site);
+        if (at == SIZE_MAX)
+        {
+            *console << "[-] 0x" << std::hex << site << std::dec << " is not in an executable section\n";
+            return false;
+        }
+
+        // Decode instructions until the longest signature worth considering
+        const uint8_t* code = index.Text() + at;
+        const size_t available = std::min(maxLength + 15, index.RangeRemaining(at));
+        std::vector<uint8_t> value, mask;
+        size_t firstLength = 0;
+        while (value.size() < maxLength)
+        {
+            DecodedInstruction instruction;
+            const size_t offset = value.size();
+            if (!DecodeInstruction(code + offset, available - offset, x64, instruction))
+                break;
+
+            for (size_t i = 0; i < instruction.length; i++)
+            {
+                bool address = (instruction.ripRelative || instruction.absoluteAddress) && instruction.dispSize == 4 &&
+                               i >= instruction.dispOffset && i < instruction.dispOffset + instruction.dispSize;
+                bool branch = instruction.relativeBranch && i >= instruction.immOffset;
+                bool wild = address || branch || IsRelocated(static_cast<uint32_t>(site - moduleBase + offset + i));
+                value.push_back(wild ? 0 : code[offset + i]);
+                mask.push_back(wild ? 0 : 0xFF);
+            }
+
+            if (!firstLength)
+            {
+                ResolveRule rule;
+                firstLength = instruction.length;
+                out.hasRule = AddressRule(instruction, !x64 && instruction.immSize == 4 &&
+                                          IsAddressImmediate(static_cast<uint32_t>(site - moduleBase + instruction.immOffset)), rule);
+                out.rule = MemoryOperand();
+            }
+        }
+
+        if (!firstLength)
+        {
+            *console << "[-] Could not decode an instruction at 0x" << std::hex << site << std::dec << "\n";
+            return false;
+        }
+
+        auto matches = [&](size_t length, size_t limit)
+        {
+            SignatureView view = { value.data(), mask.data(), length, 0, 0, false, "" };
+            return index.Count(view, limit);
+        };
+
+        // Matches only shrink as the signature grows, so binary search the
+        // shortest unique length; the first instruction is always kept whole
+        // so the resolve rule's operand is inside the signature
+        size_t length = value.size();
+        out.matches = matches(length, SIZE_MAX);
+        if (out.matches == 1)
+        {
+            size_t lo = firstLength, hi = length;
+            while (lo < hi)
+            {
+                size_t mid = (lo + hi) / 2;
+                if (matches(mid, 2) == 1)
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+            length = lo;
+        }
+
+        std::ostringstream text;
+        text << std::hex << std::uppercase << std::setfill('0');
+        for (size_t i = 0; i < length; i++)
+        {
+            if (i)
+                text << ' ';
+            if (mask[i])
+                text << std::setw(2) << static_cast<int>(value[i]);
+            else
+                text << '?';
+        }
+        out.pattern = text.str();
+        return out.matches == 1;
+    }
+
+    // Signature source line for a resolve rule, as read by CompileSignatureSource
+    static std::string RuleText(const ResolveRule& rule)
+    {
+        if (rule.kind == ResolveKind::MemoryOperand)
+            return "ref";
+        if (rule.kind == ResolveKind::RipRelative)
+            return "rip " + std::to_string(rule.operandOffset) + " " + std::to_string(rule.instructionLength);
+        return "abs " + std::to_string(rule.operandOffset);
+    }
+
+    // Non-executable, non-writable initialized data (.rdata); every readable
+    // range when the module has no PE headers
+    std::vector<ScanRange> ReadOnlyDataRanges() const
+    {
+        if (!hasPEInfo)
+            return readableRanges;
+
+        std::vector<ScanRange> ranges;
+        for (const auto& section : peInfo.sections)
+        {
+            if ((section.characteristics & (kSectionExecute | kSectionWrite)) || !(section.characteristics & kSectionInitializedData) ||
+                section.rva >= moduleSize)
+                continue;
+            size_t size = std::min<size_t>(std::max(section.virtualSize, section.rawSize), moduleSize - section.rva);
+            ranges.push_back({ moduleBase + section.rva, size });
+        }
+        return ranges;
+    }
+
+    // Strings of the module's read-only data, extracted on first use
+    const StringTable& Strings()
+    {
+        if (!stringTable)
+        {
+            auto start = std::chrono::steady_clock::now();
+            auto table = std::make_shared<StringTable>();
+            std::vector<uint8_t> data;
+            size_t total = 0;
+            for (const auto& range : ReadOnlyDataRanges())
+            {
+                data.resize(range.size);
+                ReadChunk(range.start, data.data(), data.size());
+                table->Add(data.data(), data.size(), static_cast<uint32_t>(range.start - moduleBase));
+                total += range.size;
+            }
+            table->Finish();
+            stringTable = table;
+            *console << "[+] Found " << stringTable->Size() << " strings in 0x" << std::hex << total << std::dec
+                      << " bytes of read-only data in " << std::fixed << std::setprecision(0)
+                      << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+                      << " ms\n" << std::defaultfloat;
+        }
+        return *stringTable;
+    }
+
+    // Is `text` at `address`, NUL-terminated, as ASCII or UTF-16?
+    bool StringAt(uintptr_t address, const SignatureView& text)
+    {
+        std::vector<uint8_t> bytes(text.length * 2 + 2);
+        const size_t got = address ? memory->ReadPrefix(address, bytes.data(), bytes.size()) : 0;
+        if (got > text.length && !bytes[text.length] && memcmp(bytes.data(), text.value, text.length) == 0)
+            return true;
+        if (got < bytes.size() || bytes[text.length * 2] || bytes[text.length * 2 + 1])
+            return false;
+        for (size_t i = 0; i < text.length; i++)
+        {
+            if (bytes[i * 2] != text.value[i] || bytes[i * 2 + 1])
+                return false;
+        }
+        return true;
+    }
+
+    // Code that refers to any copy of `text`, in address order
+    std::vector<Xref> StringReferences(const std::string& text)
+    {
+        std::vector<Xref> references;
+        for (const auto& entry : Strings().Find(text))
+        {
+            for (const Xref& reference : Xrefs().To(entry.rva))
+                references.push_back(reference);
+        }
+        std::sort(references.begin(), references.end(), [](const Xref& a, const Xref& b) { return a.site < b.site; });
+        return references;
+    }
+
+    // The x64 function table (.pdata), sorted by start address
+    const std::vector<RuntimeFunction>& FunctionTable()
+    {
+        if (functionTableLoaded)
+            return functionTable;
+        functionTableLoaded = true;
+
+        if (!hasPEInfo || !peInfo.is64 || !peInfo.exceptionRva || peInfo.exceptionRva >= moduleSize)
+            return functionTable;
+
+        functionTable.resize(std::min<size_t>(peInfo.exceptionSize, moduleSize - peInfo.exceptionRva) / sizeof(RuntimeFunction));
+        if (!ReadInto(moduleBase + peInfo.exceptionRva, reinterpret_cast<uint8_t*>(functionTable.data()),
+                      functionTable.size() * sizeof(RuntimeFunction)))
+            functionTable.clear();
+        std::sort(functionTable.begin(), functionTable.end(),
+                  [](const RuntimeFunction& a, const RuntimeFunction& b) { return a.begin < b.begin; });
+        return functionTable;
+    }
+
+    // Start of the function containing `site`. x64 modules list their
+    // functions in .pdata; a chained entry covers one part of a function and
+    // leads to its primary entry. Leaf functions and x86 code have no table, so
+    // fall back to the nearest 16-byte boundary after int3 padding, which is
+    // how MSVC separates functions. `site` itself if neither finds a start.
+    uintptr_t FunctionStart(uintptr_t site)
+    {
+        const uint32_t rva = static_cast<uint32_t>(site - moduleBase);
+        const std::vector<RuntimeFunction>& table = FunctionTable();
+        auto it = std::upper_bound(table.begin(), table.end(), rva,
+                                   [](uint32_t value, const RuntimeFunction& function) { return value < function.begin; });
+        if (it != table.begin() && rva < (it - 1)->end)
+        {
+            RuntimeFunction function = *(it - 1);
+            for (int depth = 0; depth < 8; depth++)
+            {
+                // UNWIND_INFO: version:3 flags:5, prologue size, code count, frame; chained entry after the codes
+                uint8_t header[4];
+                if (!ReadInto(moduleBase + function.unwind, header, sizeof(header)) || !((header[0] >> 3) & 0x4))
+                    break;
+                const uint32_t chained = function.unwind + 4 + 2 * ((header[2] + 1u) & ~1u);
+                if (!ReadInto(moduleBase + chained, reinterpret_cast<uint8_t*>(&function), sizeof(function)))
+                    break;
+            }
+            return moduleBase + function.begin;
+        }
+
+        for (const auto& range : codeRanges)
+        {
+            if (site < range.start || site - range.start >= range.size)
+                continue;
+
+            // Look back no further than the first unreadable page before the site
+            const size_t window = std::min<size_t>(site - range.start, 0x10000);
+            uintptr_t first = site - window;
+            std::vector<uint8_t> bytes(window);
+            for (size_t done = 0; first < site; first = std::min(site, ((first + done) | (PageCache::kPageSize - 1)) + 1))
+            {
+                done = memory->ReadPrefix(first, bytes.data(), site - first);
+                if (done == site - first)
+                    break;
+            }
+            for (uintptr_t at = site & ~uintptr_t(15); at > first; at -= 16)
+            {
+                if (bytes[at - 1 - first] == 0xCC)
+                    return at;
+            }
+            return first == range.start ? range.start : site;
+        }
+        return site;
+    }
+
+    // Resolve a func "<string>" signature to the function whose code refers
+    // to the string. References from more than one function are ambiguous.
+    bool ResolveStringTarget(const std::string& target, const TargetSignature& signature)
+    {
+        const std::string text(reinterpret_cast<const char*>(signature.view.value), signature.view.length);
+        const std::vector<Xref> references = StringReferences(text);
+        if (references.empty())
+        {
+            *console << "    [-] No code refers to \"" << text << "\"\n";
+            return false;
+        }
+
+        std::vector<uintptr_t> functions;
+        for (const Xref& reference : references)
+            functions.push_back(FunctionStart(moduleBase + reference.site));
+        const uintptr_t site = moduleBase + references.front().site;
+        const uintptr_t address = functions.front();
+        std::sort(functions.begin(), functions.end());
+        functions.erase(std::unique(functions.begin(), functions.end()), functions.end());
+
+        *console << "    Referenced at: 0x" << std::hex << site << "\n";
+        *console << "    Function: 0x" << address << std::dec << "\n";
+
+        TargetResult& result = targetResults[target];
+        result = { address, site, signature.view.text };
+        result.matches = references.size();
+        result.globals = functions.size();
+        if (result.globals > 1)
+            *console << "    [!] Ambiguous: " << result.matches << " references from " << result.globals << " different functions\n";
+        else
+            *console << "    Matches: " << result.matches << " (unique)\n";
+        return true;
+    }
+
+    // Garry's Mod specific patterns (Source Engine)
+    uintptr_t ScanGModEntityList()
+    {
+        return ScanTarget("EntityList");
+    }
+
+    // Scan for local player
+    uintptr_t ScanGModLocalPlayer()
+    {
+        return ScanTarget("LocalPlayer");
+    }
+
+    // Scan for view matrix
+    uintptr_t ScanGModViewMatrix()
+    {
+        return ScanTarget("ViewMatrix");
+    }
+
+    // Scan every target of the signature database, in database order
+    void ScanAllTargets()
+    {
+        for (const auto& target : TargetNames())
+            ScanTarget(target);
+    }
+
+    // Names of the targets in the signature database, in database order,
+    // narrowed to targetFilter when one is set
+    std::vector<std::string> TargetNames()
+    {
+        std::vector<std::string> names;
+        const SignatureDatabase& database = Signatures();
+        for (size_t target = 0; target < database.TargetCount(); target++)
+        {
+            const char* name = database.TargetName(target);
+            if (targetFilter.empty() || std::find(targetFilter.begin(), targetFilter.end(), name) != targetFilter.end())
+                names.push_back(name);
+        }
+        return names;
+    }
+
+    // Does a target's module hint (space-separated name parts, matched
+    // case-insensitively) name this module? An empty hint names every module.
+    static bool RoutedTo(const std::string& modules, const std::string& module)
+    {
+        std::string name = module;
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        std::istringstream words(modules);
+        std::string word;
+        bool any = false;
+        while (words >> word)
+        {
+            std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+            if (name.find(word) != std::string::npos)
+                return true;
+            any = true;
+        }
+        return !any;
+    }
+
+    // Signatures of a target by name that can match the module's code,
+    // empty if the database does not have it
+    std::vector<TargetSignature> TargetSignatures(const std::string& target)
+    {
+        std::vector<TargetSignature> signatures;
+        const SignatureDatabase& database = Signatures();
+        size_t index = database.FindTarget(target);
+        for (size_t i = 0; index != SIZE_MAX && i < database.PatternCount(index); i++)
+        {
+            const TargetSignature signature = database.Pattern(index, i);
+            if (CanMatch(signature))
+                signatures.push_back(signature);
+        }
+        return signatures;
+    }
+
+    // Identity of the module build: PE timestamp, image size and a hash of
+    // its code. The hash samples the first page of every code section plus
+    // up to 64 evenly spaced pages, so it costs a few hundred KB of reads
+    // instead of the whole image.
+    std::string ModuleFingerprint()
+    {
+        const size_t pageSize = 0x1000;
+        uint64_t hash = 0xCBF29CE484222325ull;
+        std::vector<uint8_t> page(pageSize);
+
+        auto mix = [&](uintptr_t address, size_t size)
+        {
+            if (ReadablePieces(address, size).size() != 1 || !ReadInto(address, page.data(), size))
+                return;
+            for (size_t i = 0; i + 8 <= size; i += 8)
+            {
+                uint64_t word;
+                memcpy(&word, page.data() + i, 8);
+                hash = (hash ^ word) * 0x9E3779B97F4A7C15ull;
+                hash ^= hash >> 29;
+            }
+        };
+
+        for (const auto& range : codeRanges)
+        {
+            size_t pages = (range.size + pageSize - 1) / pageSize;
+            size_t step = std::max<size_t>(pages / 64, 1);
+            for (size_t index = 0; index < pages; index += step)
+                mix(range.start + index * pageSize, std::min(pageSize, range.size - index * pageSize));
+        }
+
+        std::ostringstream out;
+        out << std::hex << std::setfill('0') << std::setw(8) << (hasPEInfo ? peInfo.timeDateStamp : 0) << "-"
+            << std::setw(8) << (hasPEInfo ? peInfo.sizeOfImage : moduleSize) << "-" << std::setw(16) << hash;
+        return out.str();
+    }
+
+    // Load results for this module build from the cache file and check that
+    // every cached signature still matches, within the bytes an approximate
+    // result differed by, and resolves to the same RVA.
+    bool LoadCachedResults(const std::string& filename)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::string fingerprint = ModuleFingerprint();
+        auto hashed = std::chrono::steady_clock::now();
+
+        std::ifstream file(filename);
+        if (!file.is_open())
+            return false;
+
+        std::map<std::string, TargetResult> cached;
+        std::string line;
+        bool inSection = false;
+        while (std::getline(file, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (line.empty() || line[0] == ';')
+                continue;
+            if (line[0] == '[')
+            {
+                inSection = line == "[" + fingerprint + "]";
+                continue;
+            }
+            if (!inSection)
+                continue;
+
+            // Target=0x<rva>,0x<site rva>,<mismatches>,<pattern>
+            size_t eq = line.find('=');
+            size_t c1 = line.find(',', eq);
+            size_t c2 = c1 == std::string::npos ? c1 : line.find(',', c1 + 1);
+            size_t c3 = c2 == std::string::npos ? c2 : line.find(',', c2 + 1);
+            if (eq == std::string::npos || c3 == std::string::npos)
+                continue;
+
+            TargetResult result;
+            uintptr_t rva = strtoull(line.substr(eq + 1, c1 - eq - 1).c_str(), nullptr, 16);
+            uintptr_t siteRva = strtoull(line.substr(c1 + 1, c2 - c1 - 1).c_str(), nullptr, 16);
+            result.mismatches = strtoull(line.substr(c2 + 1, c3 - c2 - 1).c_str(), nullptr, 10);
+            result.pattern = line.substr(c3 + 1);
+            if (!result.pattern.empty())
+            {
+                result.address = moduleBase + rva;
+                result.site = moduleBase + siteRva;
+            }
+            cached[line.substr(0, eq)] = result;
+        }
+
+        // Every target of the current signature database must be cached
+        for (const auto& target : TargetNames())
+        {
+            if (!cached.count(target))
+                return false;
+        }
+
+        // Re-validate: the winning pattern must still match at the cached site
+        for (const auto& entry : cached)
+        {
+            const TargetResult& result = entry.second;
+            if (result.pattern.empty())
+                continue;
+
+            std::vector<TargetSignature> patterns = TargetSignatures(entry.first);
+            auto it = std::find_if(patterns.begin(), patterns.end(),
+                                   [&](const TargetSignature& pattern) { return result.pattern == pattern.view.text; });
+            if (it == patterns.end())
+                return false;
+
+            if (it->rule.kind == ResolveKind::StringFunction)
+            {
+                if (!StringAt(ResolveSite(MemoryOperand(), result.site), it->view) || FunctionStart(result.site) != result.address)
+                    return false;
+                continue;
+            }
+
+            uint8_t bytes[64];
+            if (it->view.size() > sizeof(bytes) || !ReadInto(result.site, bytes, it->view.size()) ||
+                it->view.Mismatches(bytes) > result.mismatches || ResolveSite(it->rule, result.site) != result.address)
+                return false;
+        }
+
+        targetResults = cached;
+        auto done = std::chrono::steady_clock::now();
+        *console << "\n[+] Cache hit for " << fingerprint << std::fixed << std::setprecision(0)
+                  << " (fingerprint " << std::chrono::duration<double, std::micro>(hashed - start).count()
+                  << " us, validated in " << std::chrono::duration<double, std::micro>(done - hashed).count()
+                  << " us)\n" << std::defaultfloat;
+        return true;
+    }
+
+    // Write this module's results into the cache file, keeping other builds
+    void StoreCachedResults(const std::string& filename)
+    {
+        std::string fingerprint = ModuleFingerprint();
+
+        // Keep every other section of the existing file
+        std::vector<std::string> kept;
+        {
+            std::ifstream file(filename);
+            std::string line;
+            bool skip = false;
+            while (std::getline(file, line))
+            {
+                if (!line.empty() && line.back() == '\r')
+                    line.pop_back();
+                if (!line.empty() && line[0] == '[')
+                    skip = line == "[" + fingerprint + "]";
+                if (!skip && !line.empty())
+                    kept.push_back(line);
+            }
+        }
+
+        std::ostringstream file;
+        for (const auto& line : kept)
+            file << line << "\n";
+
+        file << "[" << fingerprint << "]\n";
+        for (const auto& entry : targetResults)
+        {
+            const TargetResult& result = entry.second;
+            file << entry.first << "=0x" << std::hex << (result.address ? result.address - moduleBase : 0)
+                 << ",0x" << (result.site ? result.site - moduleBase : 0) << std::dec << "," << result.mismatches << ","
+                 << result.pattern << "\n";
+        }
+        WriteFileAtomically(filename, file.str());
+    }
+
+    // Results of database targets other than the three built-in ones
+    std::vector<std::pair<std::string, uintptr_t>> ExtraTargets()
+    {
+        std::vector<std::pair<std::string, uintptr_t>> extra;
+        for (const auto& target : TargetNames())
+        {
+            if (target != "EntityList" && target != "LocalPlayer" && target != "ViewMatrix")
+                extra.push_back({ target, targetResults[target].address });
+        }
+        return extra;
+    }
+
+    // Save results
+    void SaveResults(const std::string& filename, uintptr_t entityList, uintptr_t localPlayer, uintptr_t viewMatrix)
+    {
+        std::ostringstream file;
+
+        file << "// Garry's Mod Offsets\n";
+        file << "// Process: " << processName << "\n";
+        file << "// Generated: " << __DATE__ << " " << __TIME__ << "\n\n";
+
+        file << "[Offsets]\n";
+        file << "EntityList=0x" << std::hex << entityList << "\n";
+        file << "LocalPlayer=0x" << localPlayer << "\n";
+        file << "ViewMatrix=0x" << viewMatrix << "\n";
+        for (const auto& target : ExtraTargets())
+            file << target.first << "=0x" << target.second << "\n";
+
+        if (resultModules.empty())
+        {
+            file << "\n[Module]\n";
+            file << "Base=0x" << moduleBase << "\n";
+            file << "Size=0x" << moduleSize << "\n";
+        }
+        else
+        {
+            file << "\n[Modules] ; Target=module,base,size\n";
+            for (const auto& entry : resultModules)
+                file << entry.first << "=" << entry.second.name << ",0x" << entry.second.base << ",0x" << entry.second.size << "\n";
+        }
+
+        file << "\n[Sites] ; instruction RVAs, used by --rescan\n";
+        for (const auto& entry : targetResults)
+        {
+            auto module = resultModules.find(entry.first);
+            if (entry.second.site)
+                file << entry.first << "=0x" << entry.second.site - (module == resultModules.end() ? moduleBase : module->second.base) << "\n";
+        }
+
+        file << "\n[Entity] ; Source Engine typical offsets\n";
+        file << "Health=0x100\n";
+        file << "Team=0x104\n";
+        file << "Position=0x138\n";
+        file << "Dormant=0xED\n";
+        file << "BoneMatrix=0x26A8\n";
+
+        if (!WriteFileAtomically(filename, file.str()))
+        {
+            *console << "\n[-] Failed to write " << filename << "\n";
+            return;
+        }
+        *console << "\n[+] Results saved to: " << filename << "\n";
+    }
+
+    // Generate header
+    void GenerateHeader(const std::string& filename, uintptr_t entityList, uintptr_t localPlayer, uintptr_t viewMatrix)
+    {
+        std::ostringstream file;
+
+        file << "// Garry's Mod Auto-Generated Offsets\n";
+        file << "// Process: " << processName << "\n\n";
+
+        file << "#pragma once\n\n";
+        file << "namespace GModOffsets\n{\n";
+        // Merged reports note the module of each offset
+        auto origin = [&](const std::string& target)
+        {
+            auto module = resultModules.find(target);
+            return module == resultModules.end() ? std::string() : " // " + module->second.name;
+        };
+
+        file << "    // Global offsets\n";
+        file << "    constexpr uintptr_t EntityList = 0x" << std::hex << entityList << ";" << origin("EntityList") << "\n";
+        file << "    constexpr uintptr_t LocalPlayer = 0x" << localPlayer << ";" << origin("LocalPlayer") << "\n";
+        file << "    constexpr uintptr_t ViewMatrix = 0x" << viewMatrix << ";" << origin("ViewMatrix") << "\n";
+        for (const auto& target : ExtraTargets())
+            file << "    constexpr uintptr_t " << target.first << " = 0x" << target.second << ";" << origin(target.first) << "\n";
+        file << "\n";
+
+        file << "    // Source Engine entity offsets (typical values)\n";
+        file << "    namespace Entity\n";
+        file << "    {\n";
+        file << "        constexpr uintptr_t Health = 0x100;\n";
+        file << "        constexpr uintptr_t Team = 0x104;\n";
+        file << "        constexpr uintptr_t Position = 0x138;\n";
+        file << "        constexpr uintptr_t Dormant = 0xED;\n";
+        file << "        constexpr uintptr_t BoneMatrix = 0x26A8;\n";
+        file << "    }\n";
+        file << "}\n";
+
+        if (!WriteFileAtomically(filename, file.str()))
+        {
+            *console << "[-] Failed to write " << filename << "\n";
+            return;
+        }
+        *console << "[+] Header generated: " << filename << "\n";
+    }
+
+    // Write the collected telemetry as JSON
+    bool WriteTelemetryReport(const std::string& filename)
+    {
+        if (!telemetry)
+            return false;
+
+        std::ofstream file(filename);
+        if (!file.is_open())
+        {
+            *console << "[-] Failed to write telemetry: " << filename << "\n";
+            return false;
+        }
+
+        auto hex = [](uintptr_t value)
+        {
+            std::ostringstream out;
+            out << "\"0x" << std::hex << value << "\"";
+            return out.str();
+        };
+
+        const char* simd = "";
+        SelectFindFirst(&simd);
+        const CountingMemorySource& reads = *telemetry->reads;
+        double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - telemetry->started).count();
+
+        file << "{\n";
+        file << "  \"module\": " << JsonString(moduleName) << ",\n";
+        file << "  \"moduleBase\": " << hex(moduleBase) << ",\n";
+        file << "  \"moduleSize\": " << moduleSize << ",\n";
+        file << "  \"threads\": " << threadCount << ",\n";
+        file << "  \"matcher\": " << JsonString(simd) << ",\n";
+        file << "  \"countersCompiled\": " << (GMOD_TELEMETRY ? "true" : "false") << ",\n";
+        file << "  \"totalMs\": " << totalMs << ",\n";
+        file << "  \"reads\": { \"calls\": " << reads.readCalls << ", \"bytes\": " << reads.bytesRead
+             << ", \"failed\": " << reads.failedReads << ", \"views\": " << reads.viewCalls
+             << ", \"viewBytes\": " << reads.bytesViewed << " },\n";
+        if (pageCache)
+            file << "  \"pageCache\": { \"hits\": " << pageCache->hits << ", \"misses\": " << pageCache->misses
+                 << ", \"stored\": " << pageCache->stored << ", \"evictions\": " << pageCache->evictions << " },\n";
+
+        file << "  \"operations\": [";
+        for (size_t i = 0; i < telemetry->operations.size(); i++)
+        {
+            const auto& op = telemetry->operations[i];
+            file << (i ? ",\n" : "\n") << "    { \"kind\": " << JsonString(op.kind) << ", \"pattern\": " << JsonString(op.pattern)
+                 << ", \"patterns\": " << op.patterns << ", \"bytesScanned\": " << op.bytesScanned
+                 << ", \"candidates\": " << op.candidates << ", \"fullCompares\": " << op.fullCompares
+                 << ", \"ms\": " << op.ms << ", \"result\": " << hex(op.result) << " }";
+        }
+        file << (telemetry->operations.empty() ? "],\n" : "\n  ],\n");
+
+        file << "  \"attempts\": [";
+        for (size_t i = 0; i < telemetry->attempts.size(); i++)
+        {
+            const auto& attempt = telemetry->attempts[i];
+            file << (i ? ",\n" : "\n") << "    { \"target\": " << JsonString(attempt.target)
+                 << ", \"pattern\": " << JsonString(attempt.pattern) << ", \"source\": " << JsonString(attempt.source)
+                 << ", \"site\": " << hex(attempt.site) << ", \"accepted\": " << (attempt.accepted ? "true" : "false")
+                 << ", \"rejected\": " << attempt.rejected << ", \"rescanned\": " << (attempt.rescanned ? "true" : "false")
+                 << ", \"ms\": " << attempt.ms << " }";
+        }
+        file << (telemetry->attempts.empty() ? "]\n" : "\n  ]\n");
+        file << "}\n";
+
+        *console << "[+] Telemetry written to: " << filename << "\n";
+        return true;
+    }
+};
+
+// Interactive menu
+void ShowMenu()
+{
+    std::cout << "\n========================================\n";
+    std::cout << "  Garry's Mod Offset Scanner\n";
+    std::cout << "  Educational purposes only!\n";
+    std::cout << "========================================\n\n";
+}
+
+// Time the signature pass with 1..N threads
+void ReportThreadScaling(GModOffsetScanner& scanner)
+{
+    const size_t maxThreads = scanner.threadCount;
+    std::vector<size_t> counts;
+    for (size_t n = 1; n < maxThreads; n *= 2)
+        counts.push_back(n);
+    counts.push_back(maxThreads);
+
+    size_t scanned = 0;
+    for (const auto& range : scanner.codeRanges)
+        scanned += range.size;
+
+    std::cout << "\n[*] Thread scaling (signature pass over 0x" << std::hex << scanned << std::dec << " bytes):\n";
+    double baseline = 0;
+    for (size_t n : counts)
+    {
+        scanner.SetThreadCount(n);
+        scanner.GetPool();
+
+        auto start = std::chrono::steady_clock::now();
+        scanner.RunSignaturePass();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (n == 1)
+            baseline = seconds;
+
+        std::cout << "    " << std::setw(3) << n << " thread(s): " << std::fixed << std::setprecision(2)
+                  << seconds * 1000.0 << " ms, " << scanned / seconds / (1024.0 * 1024.0) << " MB/s, x"
+                  << (seconds > 0 ? baseline / seconds : 0.0) << "\n" << std::defaultfloat;
+    }
+    scanner.SetThreadCount(maxThreads);
+}
+
+// Pick a game process interactively and attach to it
+bool SelectProcess(GModOffsetScanner& scanner)
+{
+    // List all processes
+    std::cout << "[*] Scanning for running processes...\n\n";
+    auto processes = scanner.ListProcesses();
+
+    // Filter for likely game processes
+    std::vector<std::pair<std::string, DWORD>> gameProcesses;
+    for (const auto& proc : processes)
+    {
+        std::string name = proc.first;
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        
+        // Look for game-related processes
+        if (name.find("gmod") != std::string::npos ||
+            name.find("hl2") != std::string::npos ||
+            name.find("garrysmod") != std::string::npos ||
+            name.find("srcds") != std::string::npos)
+        {
+            gameProcesses.push_back(proc);
+        }
+    }
+
+    // Show found game processes
+    if (gameProcesses.empty())
+    {
+        std::cout << "[-] No Garry's Mod processes found!\n";
+        std::cout << "\nShowing all processes instead:\n\n";
+        
+        // Show all processes
+        for (size_t i = 0; i < processes.size() && i < 50; i++)
+        {
+            std::cout << "[" << (i + 1) << "] " << processes[i].first 
+                      << " (PID: " << processes[i].second << ")\n";
+        }
+        
+        std::cout << "\nEnter process number (1-" << std::min(processes.size(), (size_t)50) << "): ";
+        int choice;
+        std::cin >> choice;
+        
+        if (choice < 1 || choice > std::min(processes.size(), (size_t)50))
+        {
+            std::cout << "[-] Invalid choice!\n";
+            std::cout << "\nPress Enter to exit...";
+            std::cin.ignore();
+            std::cin.get();
+            return false;
+        }
+        
+        DWORD selectedPid = processes[choice - 1].second;
+        std::string selectedName = processes[choice - 1].first;
+        
+        std::cout << "\n[+] Selected: " << selectedName << " (PID: " << selectedPid << ")\n";
+        
+        if (!scanner.AttachToProcess(selectedPid))
+        {
+            std::cout << "\nPress Enter to exit...";
+            std::cin.ignore();
+            std::cin.get();
+            return false;
+        }
+    }
+    else
+    {
+        std::cout << "[+] Found Garry's Mod processes:\n\n";
+        for (size_t i = 0; i < gameProcesses.size(); i++)
+        {
+            std::cout << "[" << (i + 1) << "] " << gameProcesses[i].first 
+                      << " (PID: " << gameProcesses[i].second << ")\n";
+        }
+        
+        std::cout << "\nSelect process (1-" << gameProcesses.size() << "): ";
+        int choice;
+        std::cin >> choice;
+        
+        if (choice < 1 || choice > gameProcesses.size())
+        {
+            std::cout << "[-] Invalid choice!\n";
+            std::cout << "\nPress Enter to exit...";
+            std::cin.ignore();
+            std::cin.get();
+            return false;
+        }
+        
+        DWORD selectedPid = gameProcesses[choice - 1].second;
+        
+        if (!scanner.AttachToProcess(selectedPid))
+        {
+            std::cout << "\nPress Enter to exit...";
+            std::cin.ignore();
+            std::cin.get();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Modules likely to hold game offsets; every module if none looks like one
+std::vector<std::string> CandidateModules(const std::vector<std::string>& modules)
+{
+    std::vector<std::string> gameModules;
+    for (const auto& mod : modules)
+    {
+        std::string name = mod;
+        std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+        
+        if (name.find("client") != std::string::npos ||
+            name.find("engine") != std::string::npos ||
+            name.find("server") != std::string::npos ||
+            name.find(".exe") != std::string::npos)
+        {
+            gameModules.push_back(mod);
+        }
+    }
+
+    if (gameModules.empty())
+        gameModules = modules;
+    return gameModules;
+}
+
+// Pick a module interactively
+bool SelectModule(GModOffsetScanner& scanner)
+{
+    // List modules
+    std::cout << "\n[*] Scanning for modules...\n\n";
+    auto modules = scanner.ListModules(scanner.processId);
+    
+    if (modules.empty())
+    {
+        std::cout << "[-] No modules found!\n";
+        std::cout << "\nPress Enter to exit...";
+        std::cin.ignore();
+        std::cin.get();
+        return false;
+    }
+
+    std::vector<std::string> gameModules = CandidateModules(modules);
+
+    std::cout << "[+] Found modules:\n\n";
+    for (size_t i = 0; i < gameModules.size() && i < 20; i++)
+    {
+        std::cout << "[" << (i + 1) << "] " << gameModules[i] << "\n";
+    }
+    
+    std::cout << "\nSelect module (1-" << std::min(gameModules.size(), (size_t)20) << ") [default: 1]: ";
+    std::string input;
+    std::cin.ignore();
+    std::getline(std::cin, input);
+    
+    int moduleChoice = 1;
+    if (!input.empty())
+    {
+        try {
+            moduleChoice = std::stoi(input);
+        } catch (...) {
+            moduleChoice = 1;
+        }
+    }
+    
+    if (moduleChoice < 1 || moduleChoice > std::min(gameModules.size(), (size_t)20))
+        moduleChoice = 1;
+    
+    std::string selectedModule = gameModules[moduleChoice - 1];
+    
+    if (!scanner.GetModuleInfo(selectedModule))
+    {
+        std::cout << "[-] Failed to get module info!\n";
+        std::cout << "\nPress Enter to exit...";
+        std::cin.get();
+        return false;
+    }
+
+    return true;
+}
+
+// Compile a .sig source into a .sigdb that later runs map without parsing
+bool CompileSignatureFile(const std::string& sourcePath, const std::string& outputPath)
+{
+    std::ifstream source(sourcePath);
+    if (!source.is_open())
+    {
+        std::cout << "[-] Failed to open signature source: " << sourcePath << "\n";
+        return false;
+    }
+
+    std::vector<uint8_t> image;
+    std::string error;
+    SignatureDatabase database;
+    if (!CompileSignatureSource(source, image, error) || !database.Adopt(image, error))
+    {
+        std::cout << "[-] " << sourcePath << ": " << error << "\n";
+        return false;
+    }
+
+    std::ofstream output(outputPath, std::ios::binary);
+    output.write(reinterpret_cast<const char*>(database.Image()), database.ImageSize());
+    if (!output)
+    {
+        std::cout << "[-] Failed to write: " << outputPath << "\n";
+        return false;
+    }
+
+    std::cout << "[+] Compiled " << database.TargetCount() << " targets, " << database.TotalPatterns()
+              << " patterns into " << outputPath << " (" << database.ImageSize() << " bytes)\n";
+    return true;
+}
+
+// Print a unique signature for the instruction at an address, an RVA or the
+// site of a target, as a line for GModSignatures.sig
+bool MakeSignature(GModOffsetScanner& scanner, const std::string& spec)
+{
+    uintptr_t site = 0;
+    if (scanner.Signatures().FindTarget(spec) != SIZE_MAX)
+    {
+        site = scanner.ScanTarget(spec) ? scanner.targetResults[spec].site : 0;
+        if (!site)
+        {
+            std::cout << "[-] " << spec << " not found; give the address of its instruction instead\n";
+            return false;
+        }
+    }
+    else
+    {
+        char* end = nullptr;
+        site = static_cast<uintptr_t>(strtoull(spec.c_str(), &end, 16));
+        if (spec.empty() || *end)
+        {
+            std::cout << "[-] Expected an address, RVA or target name: " << spec << "\n";
+            return false;
+        }
+        if (site < scanner.moduleSize)
+            site += scanner.moduleBase;
+    }
+
+    std::cout << "\n[*] Generating signature for 0x" << std::hex << site << " (RVA 0x" << site - scanner.moduleBase
+              << ")...\n" << std::dec;
+    scanner.CodeIndex();
+
+    auto start = std::chrono::steady_clock::now();
+    GModOffsetScanner::GeneratedSignature signature;
+    bool unique = scanner.GenerateSignature(site, signature);
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    if (signature.pattern.empty())
+        return false;
+
+    if (!unique)
+    {
+        std::cout << "[-] Not unique within 64 bytes (" << signature.matches << " matches): " << signature.pattern << "\n";
+        return false;
+    }
+
+    std::cout << "[+] Unique signature, " << std::count(signature.pattern.begin(), signature.pattern.end(), ' ') + 1
+              << " bytes, found in " << std::fixed << std::setprecision(0) << us << " us:\n" << std::defaultfloat;
+    std::cout << "    " << (signature.hasRule ? GModOffsetScanner::RuleText(signature.rule) + " " : "") << signature.pattern << "\n";
+    if (!signature.hasRule)
+        std::cout << "    [!] The instruction has no address operand; add a resolve rule by hand\n";
+    return true;
+}
+
+// List the instructions that refer to an address, an RVA or a target's global
+bool ListXrefs(GModOffsetScanner& scanner, const std::string& spec)
+{
+    uintptr_t address = 0;
+    if (scanner.Signatures().FindTarget(spec) != SIZE_MAX)
+    {
+        address = scanner.ScanTarget(spec);
+        if (!address)
+        {
+            std::cout << "[-] " << spec << " not found; give its address instead\n";
+            return false;
+        }
+    }
+    else
+    {
+        char* end = nullptr;
+        address = static_cast<uintptr_t>(strtoull(spec.c_str(), &end, 16));
+        if (spec.empty() || *end)
+        {
+            std::cout << "[-] Expected an address, RVA or target name: " << spec << "\n";
+            return false;
+        }
+        if (address < scanner.moduleSize)
+            address += scanner.moduleBase;
+    }
+    if (address - scanner.moduleBase >= scanner.moduleSize)
+    {
+        std::cout << "[-] 0x" << std::hex << address << std::dec << " is outside " << scanner.moduleName << "\n";
+        return false;
+    }
+
+    const XrefIndex& xrefs = scanner.Xrefs();
+    const std::vector<Xref> references = xrefs.To(static_cast<uint32_t>(address - scanner.moduleBase));
+    std::cout << "\n[*] References to 0x" << std::hex << address << " (RVA 0x" << address - scanner.moduleBase << "):\n";
+    for (const Xref& reference : references)
+    {
+        std::cout << "    0x" << scanner.moduleBase + reference.site << " (RVA 0x" << reference.site << ")  "
+                  << GModOffsetScanner::RuleText(reference.rule) << "\n";
+    }
+    std::cout << std::dec << (references.empty() ? "[-] " : "[+] ") << references.size() << " references\n";
+    return !references.empty();
+}
+
+// List where a string is in the module's read-only data and the code that refers to it
+bool FindString(GModOffsetScanner& scanner, const std::string& text)
+{
+    const std::vector<StringTable::Entry> found = scanner.Strings().Find(text);
+    const XrefIndex& xrefs = scanner.Xrefs();
+
+    std::cout << "\n[*] \"" << text << "\": " << found.size() << " location(s)\n" << std::hex;
+    for (const auto& entry : found)
+    {
+        std::cout << "    0x" << scanner.moduleBase + entry.rva << " (RVA 0x" << entry.rva << ")  " << (entry.wide ? "UTF-16" : "ASCII") << "\n";
+        for (const Xref& reference : xrefs.To(entry.rva))
+        {
+            std::cout << "        referenced at 0x" << scanner.moduleBase + reference.site << " in function 0x"
+                      << scanner.FunctionStart(scanner.moduleBase + reference.site) << "\n";
+        }
+    }
+    std::cout << std::dec;
+    return !found.empty();
+}
+
+// Print the pointer chains of at most `depth` dereferences that lead from a
+// root (a target's global, or an address or RVA in the module) to an
+// address: readable memory is indexed into a PointerMap once and searched
+// backwards from the address.
+template<typename Arch>
+bool FindPointerPaths(GModOffsetScanner& scanner, const std::string& rootName, uintptr_t root, uintptr_t target, size_t depth,
+                      uint32_t maxOffset, size_t budgetMB)
+{
+    const size_t kMaxChains = 1000, kMaxNodes = 1 << 20, kShown = 50;
+    const std::vector<ScanRange> regions = scanner.SnapshotRanges();
+    std::shared_ptr<MemorySource> source = scanner.pageCache ? scanner.pageCache->inner : scanner.memory;
+
+    auto start = std::chrono::steady_clock::now();
+    PointerMap<Arch> map;
+    bool complete = map.Build(regions, [&](uintptr_t address, void* out, size_t size) { return source->ReadPrefix(address, out, size); },
+                              budgetMB << 20, scanner.GetPool());
+    std::cout << "[+] Indexed " << map.Size() << " pointers in " << map.Regions() << " region(s), 0x" << std::hex
+              << map.SnapshotBytes() << std::dec << " bytes, in " << std::fixed << std::setprecision(0)
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms ("
+              << std::setprecision(1) << map.MemoryBytes() / 1048576.0 << " MB)\n" << std::defaultfloat;
+    if (!complete)
+        std::cout << "[!] The " << budgetMB << " MB budget was reached; some pointers are missing (raise --map-budget)\n";
+
+    std::cout << "\n[*] Chains from " << rootName << " (0x" << std::hex << root << ") to 0x" << target << ", offsets up to 0x"
+              << maxOffset << std::dec << ", depth up to " << depth << ":\n";
+    start = std::chrono::steady_clock::now();
+    bool truncated = false;
+    const auto chains = map.FindChains(root, target, depth, maxOffset, kMaxChains, kMaxNodes, scanner.GetPool(), truncated);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t i = 0; i < chains.size() && i < kShown; i++)
+    {
+        // [[root + 0x0] + 0x10] + 0x100
+        std::ostringstream text;
+        text << std::string(chains[i].size() - 1, '[') << rootName << std::hex;
+        for (size_t k = 0; k < chains[i].size(); k++)
+            text << (k ? "] + 0x" : " + 0x") << chains[i][k];
+        std::cout << "    " << text.str() << "\n";
+    }
+    if (chains.size() > kShown)
+        std::cout << "    ... " << chains.size() - kShown << " more\n";
+    std::cout << (chains.empty() ? "[-] " : "[+] ") << chains.size() << " chain(s) in " << std::fixed << std::setprecision(0) << ms
+              << " ms\n" << std::defaultfloat;
+    if (truncated)
+        std::cout << "[!] Search limits reached; lower --depth or --max-offset for a complete list\n";
+    return !chains.empty();
+}
+
+// --pointer-paths: resolve the root and pick the pointer width of the module's architecture
+bool PointerPaths(GModOffsetScanner& scanner, const std::string& from, const std::string& to, size_t depth, uint32_t maxOffset,
+                  size_t budgetMB)
+{
+    uintptr_t root = 0;
+    if (scanner.Signatures().FindTarget(from) != SIZE_MAX)
+    {
+        root = scanner.ScanTarget(from);
+        if (!root)
+        {
+            std::cout << "[-] " << from << " not found; give its address with --from instead\n";
+            return false;
+        }
+    }
+    else
+    {
+        char* end = nullptr;
+        root = static_cast<uintptr_t>(strtoull(from.c_str(), &end, 16));
+        if (from.empty() || *end)
+        {
+            std::cout << "[-] Expected an address, RVA or target name: " << from << "\n";
+            return false;
+        }
+        if (root < scanner.moduleSize)
+            root += scanner.moduleBase;
+    }
+
+    char* end = nullptr;
+    const uintptr_t target = static_cast<uintptr_t>(strtoull(to.c_str(), &end, 16));
+    if (to.empty() || *end)
+    {
+        std::cout << "[-] Expected an address: " << to << "\n";
+        return false;
+    }
+
+    std::cout << "\n[*] Building pointer map...\n";
+    if (scanner.CodeIs64())
+        return FindPointerPaths<ArchX64>(scanner, from, root, target, depth, maxOffset, budgetMB);
+    return FindPointerPaths<ArchX86>(scanner, from, root, target, depth, maxOffset, budgetMB);
+}
+
+// Expand batch inputs: files are taken as-is, directories are walked
+// recursively and "@list.txt" names a file with one path per line
+std::vector<std::string> CollectDumpFiles(
+const std::vector<std::string>& inputs)
+{
+    std::vector<std::string> files;
+    for (const auto& input : inputs)
+    {
+        if (!input.empty() && input[0] == '@')
+        {
+            std::ifstream list(input.substr(1));
+            if (!list.is_open())
+                std::cerr << "[-] Failed to open list: " << input.substr(1) << "\n";
+
+            std::string line;
+            while (std::getline(list, line))
+            {
+                if (!line.empty() && line.back() == '\r')
+                    line.pop_back();
+                if (!line.empty() && line[0] != '#')
+                    files.push_back(line);
+            }
+            continue;
+        }
+
+        std::error_code error;
+        if (!std::filesystem::is_directory(input, error))
+        {
+            files.push_back(input);
+            continue;
+        }
+
+        std::vector<std::string> found;
+        for (auto it = std::filesystem::recursive_directory_iterator(input, error);
+             it != std::filesystem::recursive_directory_iterator(); it.increment(error))
+        {
+            if (it->is_regular_file(error))
+                found.push_back(it->path().string());
+        }
+        std::sort(found.begin(), found.end());
+        files.insert(files.end(), found.begin(), found.end());
+    }
+    return files;
+}
+
+// One JSON object describing the scan of a single dump
+std::string BatchResultJson(size_t index, const std::string& path, GModOffsetScanner* scanner, double ms)
+{
+    std::ostringstream out;
+    out << "{\"index\":" << index << ",\"file\":" << JsonString(path);
+    if (!scanner)
+    {
+        out << ",\"ok\":false,\"error\":\"open failed\"}";
+        return out.str();
+    }
+
+    size_t found = 0;
+    std::ostringstream targets;
+    for (const auto& target : scanner->TargetNames())
+    {
+        const auto& result = scanner->targetResults[target];
+        if (targets.tellp() > 0)
+            targets << ",";
+        targets << JsonString(target) << ":";
+        if (!result.address)
+        {
+            targets << "null";
+            continue;
+        }
+
+        targets << std::hex << "{\"address\":\"0x" << result.address << "\",\"rva\":\"0x" << result.address - scanner->moduleBase
+                << "\",\"site\":\"0x" << result.site - scanner->moduleBase << "\"" << std::dec
+                << ",\"pattern\":" << JsonString(result.pattern) << ",\"matches\":" << result.matches
+                << ",\"status\":" << JsonString(GModOffsetScanner::Uniqueness(result)) << "}";
+        found++;
+    }
+
+    out << ",\"ok\":true,\"module\":" << JsonString(scanner->moduleName) << std::hex
+        << ",\"base\":\"0x" << scanner->moduleBase << "\",\"size\":\"0x" << scanner->moduleSize << "\"";
+    if (scanner->hasPEInfo)
+    {
+        out << ",\"machine\":\"0x" << scanner->peInfo.machine << "\",\"timeDateStamp\":\"0x"
+            << scanner->peInfo.timeDateStamp << "\"";
+    }
+    out << std::dec << ",\"found\":" << found << ",\"targets\":{" << targets.str() << "}"
+        << ",\"ms\":" << std::fixed << std::setprecision(2) << ms << "}";
+    return out.str();
+}
+
+// Scan many dumps at once, one module per worker, sharing one compiled
+// signature set. Writes one JSON line per module to stdout as each finishes
+// and a summary to stderr. Returns the number of modules that failed to open.
+size_t RunBatch(const std::vector<std::string>& inputs, size_t jobs, std::shared_ptr<const SignatureDatabase> database)
+{
+    std::vector<std::string> files = CollectDumpFiles(inputs);
+    const std::shared_ptr<const GModOffsetScanner::SignatureSet> signatures[] = {
+        GModOffsetScanner::BuildSignatureSet<ArchX86>(database),
+        GModOffsetScanner::BuildSignatureSet<ArchX64>(database),
+    };
+
+    std::mutex outputMutex;
+    std::atomic<size_t> failed(0);
+    std::atomic<uint64_t> totalBytes(0);
+    auto started = std::chrono::steady_clock::now();
+
+    ThreadPool pool(std::max<size_t>(1, std::min(jobs, files.size())));
+    pool.ParallelFor(files.size(), [&](size_t index)
+    {
+        auto moduleStart = std::chrono::steady_clock::now();
+
+        // Modules are the unit of parallelism, so each scan is single-threaded
+        std::ostream quiet(nullptr);
+        GModOffsetScanner scanner;
+        scanner.console = &quiet;
+        scanner.SetThreadCount(1);
+        scanner.SetSignatures(database);
+
+        bool opened = scanner.AttachToDump(files[index]);
+        if (opened)
+        {
+            scanner.signatureSet = signatures[scanner.CodeIs64()];
+            scanner.ScanAllTargets();
+            totalBytes += scanner.moduleSize;
+        }
+        else
+        {
+            failed++;
+        }
+
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - moduleStart).count();
+        std::string line = BatchResultJson(index, files[index], opened ? &scanner : nullptr, ms);
+
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << line << "\n" << std::flush;
+    });
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cerr << "[+] Batch: " << files.size() << " module(s), " << failed << " failed, " << std::fixed
+              << std::setprecision(1) << totalBytes / 1048576.0 << " MB in " << std::setprecision(2) << seconds << " s ("
+              << std::setprecision(1) << (seconds > 0 ? totalBytes / 1048576.0 / seconds : 0.0) << " MB/s, "
+              << pool.Size() << " worker(s))\n";
+    return failed;
+}
+
+// Print the results table and write gmod_offsets.ini and GModOffsets.h.
+// Returns whether anything was found.
+bool WriteReport(GModOffsetScanner& scanner)
+{
+    uintptr_t entityList = scanner.targetResults["EntityList"].address;
+    uintptr_t localPlayer = scanner.targetResults["LocalPlayer"].address;
+    uintptr_t viewMatrix = scanner.targetResults["ViewMatrix"].address;
+
+    // Display results
+    std::cout << "\n========================================\n";
+    std::cout << "  Scan Results\n";
+    std::cout << "========================================\n";
+    bool anyFound = false;
+    for (const auto& target : scanner.TargetNames())
+    {
+        const auto& result = scanner.targetResults[target];
+        auto module = scanner.resultModules.find(target);
+        std::cout << std::left << std::setw(13) << (target + ":") << std::right << (result.address ? "FOUND" : "NOT FOUND")
+                  << " [" << GModOffsetScanner::Uniqueness(result) << "]"
+                  << (module == scanner.resultModules.end() ? "" : " in " + module->second.name) << "\n";
+        anyFound |= result.address != 0;
+    }
+
+    if (anyFound)
+    {
+        scanner.SaveResults("gmod_offsets.ini", entityList, localPlayer, viewMatrix);
+        scanner.GenerateHeader("GModOffsets.h", entityList, localPlayer, viewMatrix);
+
+        std::cout << "\n[*] Next steps:\n";
+        std::cout << "    1. Copy gmod_offsets.ini to your DLL directory\n";
+        std::cout << "    2. Update Memory/Offsets.h with found values\n";
+        std::cout << "    3. Build and inject your DLL\n";
+        std::cout << "    4. Test ESP in Garry's Mod\n";
+    }
+    else
+    {
+        std::cout << "\n[-] No offsets found. Try:\n";
+        std::cout << "    1. Make sure Garry's Mod is running and in-game\n";
+        std::cout << "    2. Try different module (client.dll or engine.dll)\n";
+        std::cout << "    3. Use Cheat Engine for manual scanning\n";
+    }
+    return anyFound;
+}
+
+// Targets of the database for each module: those whose hint names the
+// module, plus every target whose hint names none of the modules
+std::vector<std::vector<std::string>> RouteTargets(const SignatureDatabase& database, const std::vector<std::string>& modules)
+{
+    std::vector<std::vector<std::string>> routed(modules.size());
+    for (size_t target = 0; target < database.TargetCount(); target++)
+    {
+        const std::string name = database.TargetName(target), hint = database.TargetModules(target);
+        bool named = false;
+        for (const auto& module : modules)
+            named |= GModOffsetScanner::RoutedTo(hint, module);
+        for (size_t m = 0; m < modules.size(); m++)
+        {
+            if (!named || GModOffsetScanner::RoutedTo(hint, modules[m]))
+                routed[m].push_back(name);
+        }
+    }
+    return routed;
+}
+
+// One module of a multi-module scan, with its own scanner and log
+struct ModuleScan
+{
+    GModOffsetScanner scanner;
+    std::ostringstream log;
+    bool opened = false;
+    bool cached = false;
+};
+
+// Scan modules of the attached process at once, each for its routed
+// targets, trying the cache first. A summary line is printed per module as
+// it finishes; the full logs, when wanted, are printed in module order
+// afterwards so they do not interleave. Cache stores happen one at a time
+// since the file is shared.
+std::vector<std::unique_ptr<ModuleScan>> ScanModules(GModOffsetScanner& attached, const std::vector<std::string>& modules,
+                                                     const std::vector<std::vector<std::string>>& routed, size_t threads,
+                                                     size_t fuzzy, const std::string& cachePath, bool showLogs)
+{
+    std::vector<std::unique_ptr<ModuleScan>> scans(modules.size());
+    if (modules.empty())
+        return scans;
+
+    std::mutex outputMutex;
+    ThreadPool pool(modules.size());
+    pool.ParallelFor(modules.size(), [&](size_t m)
+    {
+        auto moduleStart = std::chrono::steady_clock::now();
+        scans[m] = std::make_unique<ModuleScan>();
+        ModuleScan& scan = *scans[m];
+        GModOffsetScanner& scanner = scan.scanner;
+        scanner.console = &scan.log;
+        scanner.SetSignatures(attached.signatureDb);
+        scanner.SetThreadCount(std::max<size_t>(1, threads / modules.size()));
+        scanner.approximateMismatches = fuzzy;
+        scanner.targetFilter = routed[m];
+
+        scan.opened = scanner.AttachToProcess(attached.processId) && scanner.GetModuleInfo(modules[m]);
+        if (scan.opened)
+        {
+            scan.cached = !cachePath.empty() && scanner.LoadCachedResults(cachePath);
+            if (!scan.cached)
+                scanner.ScanAllTargets();
+        }
+
+        size_t found = 0;
+        for (const auto& target : routed[m])
+            found += scanner.targetResults[target].address != 0;
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - moduleStart).count();
+
+        std::lock_guard<std::mutex> lock(outputMutex);
+        std::cout << (scan.opened ? "[+] " : "[-] ") << modules[m] << ": " << found << " of " << routed[m].size()
+                  << " target(s) in " << std::fixed << std::setprecision(0) << ms << " ms" << std::defaultfloat
+                  << (scan.cached ? " (cached)" : "") << "\n" << std::flush;
+    });
+
+    for (size_t m = 0; m < modules.size() && showLogs; m++)
+        std::cout << "\n---- " << modules[m] << " ----\n" << scans[m]->log.str();
+
+    for (const auto& scan : scans)
+    {
+        if (scan->opened && !scan->cached && !cachePath.empty())
+            scan->scanner.StoreCachedResults(cachePath);
+    }
+    return scans;
+}
+
+// Merge module results into `report`: for each target the first unique
+// result in module order, else the first found
+void MergeModuleResults(const std::vector<const ModuleScan*>& scans, GModOffsetScanner& report)
+{
+    report.targetResults.clear();
+    report.resultModules.clear();
+    for (const auto& target : report.TargetNames())
+    {
+        const ModuleScan* best = nullptr;
+        for (const ModuleScan* scan : scans)
+        {
+            auto it = scan->scanner.targetResults.find(target);
+            if (!scan->opened || it == scan->scanner.targetResults.end() || !it->second.address)
+                continue;
+            if (!best || (best->scanner.targetResults.at(target).globals > 1 && it->second.globals <= 1))
+                best = scan;
+        }
+        if (!best)
+            continue;
+
+        report.targetResults[target] = best->scanner.targetResults.at(target);
+        report.resultModules[target] = { best->scanner.moduleName, best->scanner.moduleBase, best->scanner.moduleSize };
+    }
+}
+
+// Scan every candidate module of the attached process at once, each for the
+// targets its signature database hints route to it, and merge the results
+// into one report. A target whose hint names none of the candidates is
+// looked for in all of them. Returns whether anything was found.
+bool ScanAllModules(GModOffsetScanner& attached, size_t threads, size_t fuzzy, const std::string& cachePath)
+{
+    const std::vector<std::string> candidates = CandidateModules(attached.ListModules(attached.processId));
+    const std::vector<std::vector<std::string>> candidateTargets = RouteTargets(attached.Signatures(), candidates);
+
+    std::vector<std::string> modules;
+    std::vector<std::vector<std::string>> routed;
+    for (size_t m = 0; m < candidates.size(); m++)
+    {
+        if (candidateTargets[m].empty())
+            continue;
+        modules.push_back(candidates[m]);
+        routed.push_back(candidateTargets[m]);
+    }
+    if (modules.empty())
+    {
+        std::cout << "[-] No modules to scan\n";
+        return false;
+    }
+
+    std::cout << "\n[*] Scanning " << modules.size() << " module(s) concurrently:\n";
+    for (size_t m = 0; m < modules.size(); m++)
+    {
+        std::cout << "    " << modules[m] << ":";
+        for (const auto& target : routed[m])
+            std::cout << " " << target;
+        std::cout << "\n";
+    }
+
+    auto started = std::chrono::steady_clock::now();
+    const auto scans = ScanModules(attached, modules, routed, threads, fuzzy, cachePath, true);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+    GModOffsetScanner report;
+    report.processName = attached.processName;
+    report.SetSignatures(attached.signatureDb);
+    std::vector<const ModuleScan*> merged;
+    for (const auto& scan : scans)
+        merged.push_back(scan.get());
+    MergeModuleResults(merged, report);
+
+    std::cout << "\n[+] Scanned " << modules.size() << " module(s) in " << std::fixed << std::setprecision(0) << ms << " ms\n"
+              << std::defaultfloat;
+    return WriteReport(report);
+}
+
+// Keep the offsets files current while the game runs: poll the module list
+// every `interval` and, when a watched module is loaded, unloaded, moves
+// (base or size changes, as client.dll does across map changes) or is
+// replaced by another build (PE timestamp changes, as after an update),
+// rescan just that module. The cache revalidates known builds
+// without a full scan. gmod_offsets.ini and GModOffsets.h are rewritten
+// whenever a resolved address changes; a target that is not found (its
+// module unloaded or mid-reload) keeps its last resolved value, and nothing
+// is written until something has been found. An empty `watched` watches
+// every candidate module. Returns when the process exits.
+bool WatchModules(GModOffsetScanner& attached, const std::vector<std::string>& watched, size_t threads, size_t fuzzy,
+                  const std::string& cachePath, std::chrono::milliseconds interval)
+{
+    using LoadedModule = GModOffsetScanner::LoadedModule;
+    std::map<std::string, LoadedModule> known;                       // by lowercase name
+    std::map<std::string, uint32_t> stamps;                         // same keys
+    std::map<std::string, std::unique_ptr<ModuleScan>> scans;       // same keys
+    std::map<std::string, uintptr_t> written;
+    std::map<std::string, std::pair<GModOffsetScanner::TargetResult, LoadedModule>> resolved;   // last found, by target
+
+    GModOffsetScanner report;
+    report.processName = attached.processName;
+    report.SetSignatures(attached.signatureDb);
+
+    auto lower = [](std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), ::tolower);
+        return text;
+    };
+    auto hex = [](uintptr_t value)
+    {
+        std::ostringstream out;
+        out << "0x" << std::hex << value;
+        return out.str();
+    };
+
+    // PE TimeDateStamp, read past the page cache so a new build is seen; 0 if unreadable
+    std::shared_ptr<MemorySource> source = attached.pageCache ? attached.pageCache->inner : attached.memory;
+    auto buildStamp = [&](const LoadedModule& module)
+    {
+        uint32_t peOffset = 0, stamp = 0;
+        if (!source->Read(module.base + 0x3C, &peOffset, sizeof(peOffset)) || peOffset >= std::min<size_t>(module.size, 0x1000) ||
+            !source->Read(module.base + peOffset + 8, &stamp, sizeof(stamp)))
+            return 0u;
+        return stamp;
+    };
+
+    std::cout << "\n[*] Watching " << (watched.empty() ? "all game modules" : watched.front()) << " of " << attached.processName
+              << ", polling every " << interval.count() << " ms (Ctrl+C to stop)\n";
+
+    for (bool first = true;; first = false)
+    {
+        if (!first)
+        {
+            std::cout << std::flush;
+            std::this_thread::sleep_for(interval);
+        }
+
+        const std::vector<LoadedModule> snapshot = attached.ModuleSnapshot(attached.processId);
+        if (snapshot.empty())
+        {
+            std::cout << "[*] Process exited\n";
+            return true;
+        }
+
+        // Watched modules as loaded right now
+        std::vector<std::string> names;
+        for (const auto& module : snapshot)
+            names.push_back(module.name);
+        const std::vector<std::string> wanted = watched.empty() ? CandidateModules(names) : watched;
+        std::map<std::string, LoadedModule> current;
+        for (const auto& module : snapshot)
+        {
+            for (const auto& name : wanted)
+            {
+                if (_stricmp(module.name.c_str(), name.c_str()) == 0)
+                    current[lower(module.name)] = module;
+            }
+        }
+
+        // Modules that appeared, moved, were replaced or went away since the last poll
+        std::vector<std::string> changed;
+        for (const auto& entry : current)
+        {
+            auto previous = known.find(entry.first);
+            const uint32_t stamp = buildStamp(entry.second), previousStamp = stamps[entry.first];
+            stamps[entry.first] = stamp;
+            if (previous == known.end())
+                std::cout << "[*] " << entry.second.name << " loaded at " << hex(entry.second.base) << ", size " << hex(entry.second.size) << "\n";
+            else if (previous->second.base != entry.second.base || previous->second.size != entry.second.size)
+                std::cout << "[*] " << entry.second.name << " moved from " << hex(previous->second.base) << " to " << hex(entry.second.base)
+                          << ", size " << hex(entry.second.size) << "\n";
+            else if (stamp != previousStamp)
+                std::cout << "[*] " << entry.second.name << " was replaced by another build (timestamp " << hex(stamp) << ")\n";
+            else
+                continue;
+            changed.push_back(entry.second.name);
+        }
+        bool unloaded = false;
+        for (const auto& entry : known)
+        {
+            if (!current.count(entry.first))
+            {
+                std::cout << "[*] " << entry.second.name << " unloaded\n";
+                scans.erase(entry.first);
+                stamps.erase(entry.first);
+                unloaded = true;
+            }
+        }
+        known = current;
+        if (changed.empty() && !unloaded)
+            continue;
+
+        // Routing looks at every watched module, so hinted targets still go where they belong
+        std::vector<std::string> all;
+        for (const auto& entry : current)
+            all.push_back(entry.second.name);
+        const std::vector<std::vector<std::string>> allRouted = RouteTargets(attached.Signatures(), all);
+        std::vector<std::string> rescan;
+        std::vector<std::vector<std::string>> routed;
+        for (const auto& name : changed)
+        {
+            const auto& targets = allRouted[std::find(all.begin(), all.end(), name) - all.begin()];
+            scans.erase(lower(name));
+            if (targets.empty())
+                continue;
+            rescan.push_back(name);
+            routed.push_back(targets);
+        }
+
+        auto rescanned = ScanModules(attached, rescan, routed, threads, fuzzy, cachePath, false);
+        for (size_t m = 0; m < rescan.size(); m++)
+            scans[lower(rescan[m])] = std::move(rescanned[m]);
+
+        // Merge in module load order and rewrite the files if any address changed
+        std::vector<const ModuleScan*> merged;
+        for (const auto& name : all)
+        {
+            auto scan = scans.find(lower(name));
+            if (scan != scans.end())
+                merged.push_back(scan->second.get());
+        }
+        MergeModuleResults(merged, report);
+
+        // A target whose module is gone or mid-reload keeps its last resolved value
+        for (const auto& target : report.TargetNames())
+        {
+            auto last = resolved.find(target);
+            if (report.targetResults[target].address)
+                resolved[target] = { report.targetResults[target], report.resultModules[target] };
+            else if (last != resolved.end())
+            {
+                std::cout << "[*] " << target << " not resolved, keeping " << hex(last->second.first.address) << " from "
+                          << last->second.second.name << "\n";
+                report.targetResults[target] = last->second.first;
+                report.resultModules[target] = last->second.second;
+            }
+        }
+        if (report.resultModules.empty())
+        {
+            std::cout << "[-] No offsets resolved yet, files not written\n";
+            continue;
+        }
+
+        std::map<std::string, uintptr_t> addresses;
+        for (const auto& target : report.TargetNames())
+            addresses[target] = report.targetResults[target].address;
+        if (addresses == written)
+        {
+            std::cout << "[*] Offsets unchanged\n";
+            continue;
+        }
+
+        for (const auto& entry : addresses)
+        {
+            auto previous = written.find(entry.first);
+            if (previous == written.end() || previous->second != entry.second)
+                std::cout << "    " << entry.first << ": " << (previous == written.end() ? "-" : hex(previous->second)) << " -> "
+                          << (entry.second ? hex(entry.second) : "not found") << "\n";
+        }
+        report.SaveResults("gmod_offsets.ini", addresses["EntityList"], addresses["LocalPlayer"], addresses["ViewMatrix"]);
+        report.GenerateHeader("GModOffsets.h", addresses["EntityList"], addresses["LocalPlayer"], addresses["ViewMatrix"]);
+        written = addresses;
+    }
+}
+
+// Define GMOD_SCANNER_NO_MAIN to include the scanner from another tool (see GModBench.cpp)
+#ifndef GMOD_SCANNER_NO_MAIN
+int main(int argc, char* argv[])
+{
+    std::string dumpPath;
+    std::string moduleName;
+    DWORD pid = 0;
+    size_t threads = 0;
+    bool threadSweep = false;
+    std::string cachePath = "gmod_scan_cache.ini";
+    std::string rescanPath;
+    std::string telemetryPath;
+    std::vector<std::string> batchInputs;
+    std::string signaturesPath;
+    std::string compileSource, compileOutput;
+    std::string makeSignature;
+    std::string xrefsOf;
+    std::string findString;
+    std::string pointerPaths;
+    std::string pointerRoot = "EntityList";
+    size_t pointerDepth = 3;
+    uint32_t maxOffset = 0x1000;
+    size_t mapBudget = 2048;
+    bool allModules = false;
+    bool watch = false;
+    size_t watchInterval = 2;
+    size_t fuzzy = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--dump" && i + 1 < argc)
+            dumpPath = argv[++i];
+        else if (arg == "--pid" && i + 1 < argc)
+            pid = static_cast<DWORD>(strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--module" && i + 1 < argc)
+            moduleName = argv[++i];
+        else if (arg == "--all-modules")
+            allModules = true;
+        else if (arg == "--watch")
+            watch = true;
+        else if (arg == "--interval" && i + 1 < argc)
+            watchInterval = std::max<size_t>(strtoul(argv[++i], nullptr, 10), 1);
+        else if (arg == "--threads" && i + 1 < argc)
+            threads = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--thread-sweep")
+            threadSweep = true;
+        else if (arg == "--cache" && i + 1 < argc)
+            cachePath = argv[++i];
+        else if (arg == "--no-cache")
+            cachePath.clear();
+        else if (arg == "--rescan" && i + 1 < argc)
+            rescanPath = argv[++i];
+        else if (arg == "--telemetry" && i + 1 < argc)
+            telemetryPath = argv[++i];
+        else if (arg == "--batch" && i + 1 < argc)
+            batchInputs.push_back(argv[++i]);
+        else if (arg == "--signatures" && i + 1 < argc)
+            signaturesPath = argv[++i];
+        else if (arg == "--fuzzy" && i + 1 < argc)
+            fuzzy = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--make-signature" && i + 1 < argc)
+            makeSignature = argv[++i];
+        else if (arg == "--xrefs" && i + 1 < argc)
+            xrefsOf = argv[++i];
+        else if (arg == "--find-string" && i + 1 < argc)
+            findString = argv[++i];
+        else if (arg == "--pointer-paths" && i + 1 < argc)
+            pointerPaths = argv[++i];
+        else if (arg == "--from" && i + 1 < argc)
+            pointerRoot = argv[++i];
+        else if (arg == "--depth" && i + 1 < argc)
+            pointerDepth = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--max-offset" && i + 1 < argc)
+            maxOffset = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 16));
+        else if (arg == "--map-budget" && i + 1 < argc)
+            mapBudget = strtoul(argv[++i], nullptr, 10);
+        else if (arg == "--compile-signatures" && i + 2 < argc)
+        {
+            compileSource = argv[++i];
+            compileOutput = argv[++i];
+        }
+        else
+        {
+            std::cout << "Usage: " << argv[0] << " [--dump <file>] [--pid <pid>] [--module <name> | --all-modules]\n"
+                      << "       [--watch [--interval <seconds>]]\n"
+                      << "       [--threads <n>] [--thread-sweep] [--cache <file> | --no-cache]\n"
+                      << "       [--rescan <previous gmod_offsets.ini>] [--telemetry <report.json>]\n"
+                      << "       [--signatures <.sigdb or .sig>] [--make-signature <address | RVA | target>]\n"
+                      << "       [--fuzzy <max mismatching bytes, 1-" << ApproximateMatcher::kMaxMismatches << ">]"
+                      << " [--xrefs <address | RVA | target>]\n"
+                      << "       [--find-string <text>]\n"
+                      << "       [--pointer-paths <address> [--from <address | RVA | target>] [--depth <n>]\n"
+                      << "        [--max-offset <hex>] [--map-budget <MB>]]\n"
+                      << "       " << argv[0] << " --batch <file | directory | @list.txt> [--batch ...] [--threads <n>]\n"
+                      << "       " << argv[0] << " --compile-signatures <source.sig> <output.sigdb>\n";
+            return 1;
+        }
+    }
+
+    if (!compileSource.empty())
+        return CompileSignatureFile(compileSource, compileOutput) ? 0 : 1;
+
+    // Signature database: --signatures, else GModSignatures.sigdb next to us, else built-in
+    std::ostream& status = batchInputs.empty() ? std::cout : std::cerr;
+    std::shared_ptr<const SignatureDatabase> signatures = GModOffsetScanner::BuiltinSignatures();
+    std::error_code missing;
+    if (signaturesPath.empty() && std::filesystem::exists("GModSignatures.sigdb", missing))
+        signaturesPath = "GModSignatures.sigdb";
+    if (!signaturesPath.empty())
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::string error;
+        signatures = GModOffsetScanner::OpenSignatures(signaturesPath, error);
+        if (!signatures)
+        {
+            std::cout << "[-] " << signaturesPath << ": " << error << "\n";
+            return 1;
+        }
+        status << "[+] Signatures: " << signaturesPath << " (" << signatures->TargetCount() << " targets, "
+               << signatures->TotalPatterns() << " patterns, loaded in " << std::fixed << std::setprecision(0)
+               << std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count()
+               << " us)\n" << std::defaultfloat;
+    }
+
+    // Headless: JSON lines on stdout, no menu, no prompts
+    if (!batchInputs.empty())
+        return RunBatch(batchInputs, threads ? threads : std::max<unsigned>(std::thread::hardware_concurrency(), 1u), signatures) ? 2 : 0;
+
+    if (pid && moduleName.empty() && !allModules)
+    {
+        std::cout << "[-] --pid needs --module or --all-modules\n";
+        return 1;
+    }
+    if (allModules && !dumpPath.empty())
+    {
+        std::cout << "[-] --all-modules scans a process; use --batch for dumps\n";
+        return 1;
+    }
+    if (watch && !dumpPath.empty())
+    {
+        std::cout << "[-] --watch follows a running process, not a dump\n";
+        return 1;
+    }
+
+    // Only pause for Enter when the user picked everything by hand
+    const bool interactive = dumpPath.empty() && !pid;
+
+    ShowMenu();
+
+    GModOffsetScanner scanner;
+    scanner.SetSignatures(signatures);
+    if (threads)
+        scanner.SetThreadCount(threads);
+    scanner.approximateMismatches = std::min(fuzzy, ApproximateMatcher::kMaxMismatches);
+
+    if (!dumpPath.empty())
+    {
+        if (!scanner.AttachToDump(dumpPath))
+            return 1;
+    }
+    else
+    {
+        if (pid)
+        {
+            if (!scanner.AttachToProcess(pid))
+                return 1;
+
+            if (!allModules && !scanner.GetModuleInfo(moduleName))
+            {
+                std::cout << "[-] Module not found: " << moduleName << "\n";
+                return 1;
+            }
+        }
+        else if (!SelectProcess(scanner) || (!allModules && !SelectModule(scanner)))
+        {
+            return 1;
+        }
+    }
+
+    if (watch)
+    {
+        const std::vector<std::string> watched = allModules ? std::vector<std::string>() : std::vector<std::string>{ scanner.moduleName };
+        return WatchModules(scanner, watched, scanner.threadCount, scanner.approximateMismatches, cachePath,
+                            std::chrono::seconds(watchInterval)) ? 0 : 1;
+    }
+
+    if (allModules)
+    {
+        ScanAllModules(scanner, scanner.threadCount, scanner.approximateMismatches, cachePath);
+        if (interactive)
+        {
+            std::cout << "\nPress Enter to exit...";
+            std::cin.ignore();
+            std::cin.get();
+        }
+        return 0;
+    }
+
+    if (threadSweep)
+        ReportThreadScaling(scanner);
+
+    if (!makeSignature.empty())
+        return MakeSignature(scanner, makeSignature) ? 0 : 1;
+
+    if (!xrefsOf.empty())
+        return ListXrefs(scanner, xrefsOf) ? 0 : 1;
+
+    if (!findString.empty())
+        return FindString(scanner, findString) ? 0 : 1;
+
+    if (!pointerPaths.empty())
+        return PointerPaths(scanner, pointerRoot, pointerPaths, pointerDepth, maxOffset, mapBudget) ? 0 : 1;
+
+    if (!telemetryPath.empty())
+        scanner.EnableTelemetry();
+
+    // Scan for offsets
+    std::cout << "\n[*] Starting Garry's Mod offset scan...\n";
+    std::cout << "    This may take a few minutes...\n";
+
+    // A cache hit for this module build skips scanning altogether
+    bool cached = !cachePath.empty() && scanner.LoadCachedResults(cachePath);
+    if (!cached)
+    {
+        if (!rescanPath.empty())
+        {
+            auto sites = scanner.LoadPreviousSites(rescanPath);
+            for (const auto& target : scanner.TargetNames())
+            {
+                if (sites.count(target))
+                    scanner.RescanTarget(target, sites[target]);
+                else
+                    scanner.ScanTarget(target);
+            }
+        }
+        else
+        {
+            scanner.ScanAllTargets();
+        }
+
+        if (!cachePath.empty())
+            scanner.StoreCachedResults(cachePath);
+    }
+
+    WriteReport(scanner);
+
+    if (!telemetryPath.empty())
+        scanner.WriteTelemetryReport(telemetryPath);
+
+    if (interactive)
+    {
+        std::cout << "\nPress Enter to exit...";
+        std::cin.get();
+    }
+    return 0;
+}
+#endif